@@ -0,0 +1,125 @@
+#ifndef BBSORT_SOLUTION_ARRAY_MEMORY_H
+#define BBSORT_SOLUTION_ARRAY_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace pool {
+
+    ///Arrays of at least that many bytes are mapped aligned to hugePageSize with transparent huge pages requested,
+    ///scattered writes to large buckets then miss TLB once per 2 MB instead of once per 4 KB page.
+    const std::size_t hugePageFrom = 1 << 21;
+
+    const std::size_t hugePageSize = 1 << 21;
+
+    ///Arrays of at least that many bytes get their pages dropped on release,
+    ///allocator may keep a freed large block mapped and resident.
+    const std::size_t adviseFrom = 1 << 20;
+
+    ///Huge page arrays are pre-faulted on allocation when BB_SORT_POOL_POPULATE is defined.
+#ifdef BB_SORT_POOL_POPULATE
+    constexpr bool populateArrays = true;
+#else
+    constexpr bool populateArrays = false;
+#endif
+
+    inline std::size_t getMappedBytes(std::size_t bytes) {
+
+        return (bytes + hugePageSize - 1) & ~(hugePageSize - 1);
+    }
+
+    inline void * allocateArray(std::size_t bytes) {
+
+#if defined(__unix__) || defined(__APPLE__)
+        if (bytes >= hugePageFrom) {
+
+            const std::size_t mapped = getMappedBytes(bytes);
+
+            //maps one huge page more and unmaps unaligned head and tail.
+            void * region = mmap(nullptr, mapped + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (region == MAP_FAILED) {
+
+                throw std::bad_alloc();
+            }
+
+            const uintptr_t begin = (uintptr_t) region;
+            const uintptr_t aligned = (begin + hugePageSize - 1) & ~(hugePageSize - 1);
+            const uintptr_t end = begin + mapped + hugePageSize;
+
+            if (aligned > begin) {
+
+                munmap(region, aligned - begin);
+            }
+
+            if (end > aligned + mapped) {
+
+                munmap((void *) (aligned + mapped), end - (aligned + mapped));
+            }
+
+#ifdef MADV_HUGEPAGE
+            madvise((void *) aligned, mapped, MADV_HUGEPAGE);
+#endif
+            if constexpr (populateArrays) {
+
+                //populating after the advice, so the region is faulted in huge pages.
+#ifdef MADV_POPULATE_WRITE
+                if (madvise((void *) aligned, mapped, MADV_POPULATE_WRITE) != 0)
+#endif
+                {
+                    const std::size_t page = sysconf(_SC_PAGESIZE);
+
+                    for (std::size_t offset = 0; offset < mapped; offset += page) {
+
+                        ((volatile char *) aligned)[offset] = 0;
+                    }
+                }
+            }
+
+            return (void *) aligned;
+        }
+#endif
+        return ::operator new(bytes);
+    }
+
+    ///Frees array allocated by allocateArray of the same bytes.
+    inline void freeArray(void * array, std::size_t bytes) {
+
+#if defined(__unix__) || defined(__APPLE__)
+        if (bytes >= hugePageFrom) {
+
+            munmap(array, getMappedBytes(bytes));
+            return;
+        }
+#endif
+        ::operator delete(array);
+    }
+
+    ///Frees array making sure its pages go back to the system.
+    inline void releaseArray(void * array, std::size_t bytes) {
+
+#if defined(__unix__) || defined(__APPLE__)
+        if (bytes >= adviseFrom && bytes < hugePageFrom) {
+
+            const uintptr_t page = sysconf(_SC_PAGESIZE);
+
+            const uintptr_t begin = ((uintptr_t) array + page - 1) & ~(page - 1);
+            const uintptr_t end = ((uintptr_t) array + bytes) & ~(page - 1);
+
+            if (begin < end) {
+
+                madvise((void *) begin, end - begin, MADV_DONTNEED);
+            }
+        }
+#endif
+        freeArray(array, bytes);
+    }
+}
+
+#endif //BBSORT_SOLUTION_ARRAY_MEMORY_H
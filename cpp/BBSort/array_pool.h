@@ -10,6 +10,8 @@
 #include <iterator>
 #include "ptr_vector.h"
 #include "array_pool_bucket.h"
+#include "shared_array_pool.h"
+#include "pool_stats.h"
 
 namespace pool {
 
@@ -22,18 +24,46 @@ namespace pool {
 
     public:
 
-        array_pool() {
+        ///Largest array length kept by pools, longer arrays are allocated and released on every rent.
+        static constexpr unsigned int maxArrayLength = 0x40000000;
 
-            const int maximumArrayLength = 0x40000000;
+        ///Pool with shared backing pool works as its thread cache: it keeps up to cacheMax idle arrays per size class,
+        ///moves surplus to shared pool, takes arrays back from it when empty and gives all of them back on destruction.
+        array_pool(shared_array_pool<T> * shared = nullptr) : shared(shared) {
 
-            int maxBuckets = selectBucketIndex(maximumArrayLength);
+            int maxBuckets = selectBucketIndex(maxArrayLength);
 
             buckets = std::vector<array_pool_bucket<array_value_type>> (maxBuckets + 1);
 
+            assert(maxBuckets < shared_array_pool<T>::sizeClasses);
+
             for (size_type i = 0; i < maxBuckets + 1; i++) {
 
                 buckets[i].arrayLen = getMaxSizeForBucket(i);
             }
+
+            if (shared != nullptr) {
+
+                shared->Stats.add(&stats);
+            }
+        }
+
+        ///Sets caps on idle arrays kept by this pool. Thread cache above them moves arrays to shared pool,
+        ///which has own limits, pool without shared one releases them.
+        void setLimits(const pool_limits & value) {
+
+            limits = value;
+        }
+
+        std::size_t getIdleBytes() const {
+
+            return idleBytes;
+        }
+
+        ///Stats of this pool only, stats of all thread caches are summed by stats of their shared pool.
+        pool_stats & getStats() {
+
+            return stats;
         }
 
         array_pointer rentArray(size_type &size) {
@@ -44,10 +74,26 @@ namespace pool {
 
                 size = buckets[index].arrayLen;
 
+                if (shared != nullptr && buckets[index].size() == 0) {
+
+                    refill(index);
+                }
+
+                const bool hit = buckets[index].size() > 0;
+
+                if (hit) {
+
+                    idleBytes -= getBytesForBucket(index);
+                }
+
+                stats.rent(index, getBytesForBucket(index), hit);
+
                 return buckets[index].rentArray();
             }
 
-            return static_cast<array_pointer>(::operator new(sizeof(array_value_type) * size));
+            stats.rent(index, sizeof(array_value_type) * size, false);
+
+            return static_cast<array_pointer>(allocateArray(sizeof(array_value_type) * size));
         }
 
         void returnArray(array_pointer array, size_type &size) {
@@ -59,27 +105,165 @@ namespace pool {
 
             int index = selectBucketIndex(size);
 
-            if (index < buckets.size()) {
+            stats.giveBack(index, index < buckets.size() ? getBytesForBucket(index) : sizeof(array_value_type) * size);
 
-                buckets[index].returnArray(array);
+            keepArray(index, array, size);
+        }
+
+        ///Releases idle arrays of this pool, thread cache gives them to shared pool instead.
+        void trim() {
+
+            for (int i = 0; i < buckets.size(); ++i) {
+
+                if (shared != nullptr) {
+
+                    spill(i, buckets[i].size());
+                }
+                else {
+
+                    idleBytes -= buckets[i].size() * getBytesForBucket(i);
+
+                    buckets[i].clear();
+                }
             }
-            else{
+        }
+
+        ///Allocates an idle array for every size ahead of first rent. Arrays above limits are not kept.
+        template<typename Sizes>
+        void warm(const Sizes & sizes) {
+
+            for (size_type size : sizes) {
+
+                int index = selectBucketIndex(size);
 
-                free(array);
+                if (index < buckets.size()) {
+
+                    size_type length = buckets[index].arrayLen;
+
+                    keepArray(index, static_cast<array_pointer>(allocateArray(sizeof(array_value_type) * length)), length);
+                }
             }
         }
 
+        ///Size class of arrays rented for bufferSize items, the same in thread caches and shared pool.
+        static int selectBucketIndex(unsigned int bufferSize) {
+
+            if (bufferSize <= 16) {
+
+                return 0;
+            }
+
+            unsigned int bits = (bufferSize - 1) >> 4;
+            return 32 - clz(bits);
+        }
+
         ~array_pool() {
 
             destroying = true;
 
+            if (shared != nullptr) {
+
+                for (int i = 0; i < buckets.size(); ++i) {
+
+                    spill(i, buckets[i].size());
+                }
+
+                shared->Stats.remove(&stats);
+            }
+
             buckets.clear();
         }
 
     private:
 
+        static constexpr int cacheMax = 2 * shared_array_pool<T>::batchSize;
+
         bool destroying = false;
 
+        pool_limits limits;
+
+        std::size_t idleBytes = 0;
+
+        ///Keeps array as idle one within limits, releases it otherwise.
+        void keepArray(int index, array_pointer array, size_type size) {
+
+            if (index < buckets.size()) {
+
+                const std::size_t bytes = getBytesForBucket(index);
+
+                if (!fits(index, bytes)) {
+
+                    if (shared != nullptr) {
+
+                        shared->give(index, &array, 1);
+                    }
+                    else {
+
+                        releaseArray(array, bytes);
+                    }
+
+                    return;
+                }
+
+                buckets[index].returnArray(array);
+
+                idleBytes += bytes;
+
+                if (shared != nullptr && buckets[index].size() >= cacheMax) {
+
+                    spill(index, shared_array_pool<T>::batchSize);
+                }
+            }
+            else{
+
+                releaseArray(array, sizeof(array_value_type) * size);
+            }
+        }
+
+        bool fits(int index, std::size_t bytes) const {
+
+            return (buckets[index].size() + 1) * bytes <= limits.ClassBytesMax && idleBytes + bytes <= limits.TotalBytesMax;
+        }
+
+        shared_array_pool<T> * shared;
+
+        pool_stats stats;
+
+        void refill(int index) {
+
+            array_pointer arrays[shared_array_pool<T>::batchSize];
+
+            const int count = shared->take(index, arrays, shared_array_pool<T>::batchSize);
+
+            for (int i = 0; i < count; ++i) {
+
+                buckets[index].returnArray(arrays[i]);
+            }
+
+            idleBytes += count * getBytesForBucket(index);
+        }
+
+        void spill(int index, int count) {
+
+            array_pointer arrays[shared_array_pool<T>::batchSize];
+
+            while (count > 0) {
+
+                const int popped = buckets[index].popArrays(arrays, std::min(count, shared_array_pool<T>::batchSize));
+
+                if (popped == 0) {
+
+                    break;
+                }
+
+                shared->give(index, arrays, popped);
+
+                idleBytes -= popped * getBytesForBucket(index);
+
+                count -= popped;
+            }
+        }
+
         std::vector <array_pool_bucket<array_value_type>> buckets;
 
         static int clz(uint32_t x) {
@@ -97,20 +281,14 @@ namespace pool {
             return debruijn32[x * 0x076be629 >> 27];
         }
 
-        static int selectBucketIndex(unsigned int bufferSize) {
-
-            if (bufferSize <= 16) {
-
-                return 0;
-            }
+        static int getMaxSizeForBucket(int binIndex) {
 
-            unsigned int bits = (bufferSize - 1) >> 4;
-            return 32 - clz(bits);
+            return shared_array_pool<T>::getArrayLength(binIndex);
         }
 
-        static int getMaxSizeForBucket(int binIndex) {
+        static std::size_t getBytesForBucket(int binIndex) {
 
-            return 16 << binIndex;
+            return shared_array_pool<T>::getArrayBytes(binIndex);
         }
     };
 }
@@ -2,9 +2,20 @@
 #define BBSORT_SOLUTION_ARRAY_POOL_BUCKET_H
 
 #include "object_pool.h"
+#include "array_memory.h"
+
+#include <cstddef>
+#include <limits>
 
 namespace pool {
 
+    ///Byte caps on idle arrays kept by a pool, arrays returned above them are released.
+    struct pool_limits {
+
+        std::size_t ClassBytesMax = std::numeric_limits<std::size_t>::max();
+        std::size_t TotalBytesMax = std::numeric_limits<std::size_t>::max();
+    };
+
     template<typename T>
     class array_pool_bucket {
 
@@ -31,7 +42,7 @@ namespace pool {
 
             if (storage.empty()) {
 
-                return static_cast<array_pointer>(::operator new(sizeof(array_value_type) * arrayLen));
+                return static_cast<array_pointer>(allocateArray(sizeof(array_value_type) * arrayLen));
             }
 
             return storage.pop();
@@ -42,6 +53,24 @@ namespace pool {
             storage.push(object);
         }
 
+        std::size_t size() const {
+
+            return storage.size();
+        }
+
+        ///Pops up to count idle arrays to arrays, returns the number popped.
+        int popArrays(array_pointer * arrays, int count) {
+
+            int popped = 0;
+
+            for (; popped < count && !storage.empty(); ++popped) {
+
+                arrays[popped] = storage.pop();
+            }
+
+            return popped;
+        }
+
         void clear() {
 
             while (true) {
@@ -53,7 +82,7 @@ namespace pool {
                     break;
                 }
 
-                free(poolItem);
+                releaseArray(poolItem, sizeof(array_value_type) * arrayLen);
             }
         }
     };
@@ -1,158 +1,140 @@
 #ifndef BBSort_H
 #define BBSort_H
 
-#define BUCKET minmax::min_max_heap<sort_item<T>, pool::vector<sort_item<T>>>
+#define BUCKET minmax::counted_bucket<T>
 
-#define STACK std::stack<BUCKET>
+#define STACK std::stack<BUCKET, std::pmr::vector<BUCKET>>
 
 #define BUCKETS pool::vector_lazy<BUCKET>
 
 #include "fast_map.h"
+#include "bucket_map.h"
+#include "bb_sort_counting.h"
+#include "partitioned_count_map.h"
+#include <algorithm>
+#include <utility>
 #include <vector>
 #include <tuple>
 #include <cmath>
+#include <ranges>
 #include <stack>
-#include <min_max_heap.h>
+#include <memory_resource>
+#include "counted_bucket.h"
+#include "memory_scope.h"
 #include "poolable_vector.h"
 #include "poolable_vector_lazy.h"
+#include "work_stealing_pool.h"
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <thread>
 
 namespace bb_sort {
 
-    inline float fastLog2(const float val) {
-        union { float val; int32_t x; } u = {val};
-        const float lg2 = (float) (((u.x >> 23) & 255) - 128);
-        u.x &= ~(255 << 23);
-        u.x += 127 << 23;
-        return lg2 + ((-0.3358287811f) * u.val + 2.0f) * u.val - 0.65871759316667f;
+    ///Bucket stack allocating from resource, which is the one of the calling thread scope by default.
+    template<typename T>
+    STACK makeStack(std::pmr::memory_resource * resource = pool::getScopeResource()) {
+
+        return STACK(std::pmr::polymorphic_allocator<BUCKET>(resource));
     }
 
     template<typename T>
-    struct sort_item {
-    public :
-        T value;
-        int count = 0;
+    void getBuckets(const bucket_map<T> &map, const BUCKET &iterable, BUCKETS &buckets) {
 
-        sort_item(){
-        }
+        const T * items = iterable.begin();
 
-        sort_item(T val) {
-            value = val;
-            count = 1;
-        }
+        map.forEachIndex(items, iterable.size(), [&](const T & item, int index) { buckets[index].push(item, iterable.getCount(&item - items)); });
+    }
 
-        friend bool operator>(const sort_item &c1, const sort_item &c2) {
-            return c1.value > c2.value;
-        }
+    template<typename T>
+    inline void fillStream(const T &val, const int count, std::vector<T> &output, const int index) {
 
-        friend bool operator<=(const sort_item &c1, const sort_item &c2) {
-            return c1.value <= c2.value;
-        }
+        for (int i = 0; i < count; ++i) {
 
-        friend bool operator<(const sort_item &c1, const sort_item &c2) {
-            return c1.value < c2.value;
-        }
+            const int newIndex = index + i;
+            if (newIndex >= output.size()){
 
-        friend bool operator>=(const sort_item &c1, const sort_item &c2) {
-            return c1.value >= c2.value;
+                break;
+            }
+            output[newIndex] = val;
         }
+    }
 
-        friend bool operator==(const sort_item &c1, const sort_item &c2) {
-            return c1.value == c2.value;
-        }
+    template<typename T>
+    int case1(STACK &st,
+              std::vector<T> &output,
+              int index) {
 
-        friend bool operator!=(const sort_item &c1, const sort_item &c2) {
-            return c1.value != c2.value;
-        }
+        const auto& top = st.top();
 
-        friend std::ostream& operator << (std::ostream& os, const sort_item& m)
-        {
-            os << "VAL:" << m.value << " , COUNT: " << m.count << std::endl;
-            return os ;
-        }
-    };
+        const auto count = top.getCount(0);
 
-    template<typename T>
-    inline float getLog(sort_item<T>* x) {
+        fillStream<T>(top.Items.array[0], count, output, index);
 
-        const float abs = std::abs(x->value);
-        if (abs < 2) {
-            return x->value;
-        }
-        const float lg = fastLog2(abs);
-        return x->value < 0 ? -lg : lg;
+        st.pop();
+
+        return count;
     }
 
-    inline float getLog(float x) {
+    template<typename T>
+    int case2(STACK &st,
+              std::vector<T> &output,
+              int index) {
 
-        const float abs = std::abs(x);
-        if (abs < 2) {
-            return x;
-        }
-        const float lg = fastLog2(abs);
-        return x < 0 ? -lg : lg;
-    }
+        const auto& top = st.top();
 
-    inline std::tuple<float, float> GetLinearTransformParams(const float x1,
-                                                             const float x2,
-                                                             const float y1,
-                                                             const float y2) {
+        const int minIndex = top.Items.array[1] < top.Items.array[0] ? 1 : 0;
+        const int maxIndex = 1 - minIndex;
 
-        const float dx = x1 - x2;
+        const auto count1 = top.getCount(minIndex);
+        const auto count2 = top.getCount(maxIndex);
 
-        if (dx != 0.0) [[likely]] {
-            const float a = (y1 - y2) / dx;
-            const float b = y1 - (a * x1);
+        fillStream<T>(top.Items.array[minIndex], count1, output, index);
+        fillStream<T>(top.Items.array[maxIndex], count2, output, index + count1);
 
-            return std::make_tuple(a, b);
-        }
+        auto count = count1 + count2;
+
+        st.pop();
 
-        return std::make_tuple(0.0, 0.0);
+        return count;
     }
 
     template<typename T>
-    void getBuckets(const BUCKET &iterable, BUCKETS &buckets, int count) {
-
-        const float minLog = getLog(iterable.findMin().value);
-        const float maxLog = getLog(iterable.findMax().value);
+    int case3(STACK &st,
+              std::vector<T> &output,
+              int index) {
 
-        const std::tuple<float, float> params = GetLinearTransformParams(minLog, maxLog, 0, count - 1);
+        const auto& top = st.top();
+        const T * items = top.Items.array;
 
-        const float a = std::get<0>(params);
-        const float b = std::get<1>(params);
+        //items of a bucket are distinct, the one neither min nor max is mid.
+        int minIndex = 0;
+        int maxIndex = 0;
 
-        for (auto const& item : iterable) {
-            // ApplyLinearTransform
-            int index = ((a * getLog(item.value) + b));
-            index = std::min(count - 1, index);
-            buckets[index].push(std::move(item));
-        }
-    }
+        for (int i = 1; i < 3; ++i) {
 
-    template<typename T>
-    inline void fillStream(const sort_item<T> &val, std::vector<T> &output, const int index) {
+            if (items[i] < items[minIndex]) {
 
-        for (int i = 0; i < val.count; ++i) {
+                minIndex = i;
+            }
 
-            const int newIndex = index + i;
-            if (newIndex >= output.size()){
+            if (items[maxIndex] < items[i]) {
 
-                break;
+                maxIndex = i;
             }
-            output[newIndex] = val.value;
         }
-    }
 
-    template<typename T>
-    int case1(STACK &st,
-              std::vector<T> &output,
-              int index) {
+        const int midIndex = 3 - minIndex - maxIndex;
 
-        auto b1 = *(st.top()).begin();
-        fillStream<T>(b1, output, index);
+        auto count1 = top.getCount(minIndex);
+        auto count2 = top.getCount(midIndex);
+        auto count3 = top.getCount(maxIndex);
 
-        auto count = b1.count;
+        fillStream<T>(items[minIndex], count1, output, index);
+        fillStream<T>(items[midIndex], count2, output, index + count1);
+        fillStream<T>(items[maxIndex], count3, output, index + count1 + count2);
+
+        const auto count = count1 + count2 + count3;
 
         st.pop();
 
@@ -160,72 +142,90 @@ namespace bb_sort {
     }
 
     template<typename T>
-    int case2(STACK &st,
-              std::vector<T> &output,
-              int index) {
+    int caseDense(STACK &st,
+                  std::vector<T> &output,
+                  int index) {
 
-        auto it = (st.top()).begin();
+        const auto& top = st.top();
 
-        const sort_item b2 = *it;
-        it++;
-        const sort_item b1 = *it;
+        const auto positions = std::views::iota(0u, top.size());
 
-        fillStream<T>(b1, output, index);
-        fillStream<T>(b2, output, index + b1.count);
-
-        auto count = b1.count + b2.count;
+        T * begin = output.data() + index;
+        T * end = bb_sort_counting::sort(positions.begin(), positions.end(), top.findMin(), top.findMax(),
+                                         begin, output.data() + output.size(),
+                                         [&](unsigned int i) { return top.Items.array[i]; },
+                                         [&](unsigned int i) { return top.getCount(i); });
 
         st.pop();
 
-        return count;
+        return end - begin;
     }
 
+    ///Bucket map can not split items of the bucket apart, they are sorted by comparisons.
     template<typename T>
-    int case3(STACK &st,
-              std::vector<T> &output,
-              int index) {
+    int caseSorted(STACK &st,
+                   std::vector<T> &output,
+                   int index) {
 
-        //single comparison
-        auto& top = st.top();
-        auto maxMidMin = top.getMaxMidMin();
+        const auto& top = st.top();
 
-        auto maxIndex = std::get<0>(maxMidMin);
-        auto midIndex = std::get<1>(maxMidMin);
-        auto minIndex = std::get<2>(maxMidMin);
+        pool::vector<std::pair<T, int>> items;
+        items.reserve(top.size());
 
-        auto count1 = top.At(minIndex).count;
-        auto count2 = top.At(midIndex).count;
+        for (unsigned int i = 0; i < top.size(); ++i) {
 
-        fillStream<T>(top.At(minIndex), output, index);
-        fillStream<T>(top.At(midIndex), output, index + count1);
-        fillStream<T>(top.At(maxIndex), output, index + count1 + count2);
+            items.emplace_back(top.Items.array[i], top.getCount(i));
+        }
 
-        const auto count = count1 + count2 + top.At(maxIndex).count;
+        std::sort(items.begin(), items.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+        int count = 0;
+
+        for (const auto& item : items) {
+
+            fillStream<T>(item.first, item.second, output, index + count);
+
+            count += item.second;
+        }
 
         st.pop();
 
         return count;
     }
 
+    ///Table is recycled between splits of a sort: children are moved out to stack before the next split resets it.
     template<typename T>
     int caseN(STACK &st,
               std::vector<T> &output,
-              int index) {
+              int index,
+              BUCKETS &table) {
+
+        if (bb_sort_counting::isDense(st.top().findMin(), st.top().findMax(), st.top().size())) {
+
+            return caseDense(st, output, index);
+        }
 
         int count = (st.top().size() / 2) + 1;
 
         count = std::min(count, 128);
 
-        BUCKETS newBuckets(count);
+        const bucket_map<T> map(st.top().findMin(), st.top().findMax(), count);
+
+        if (!map.canSplit()) {
 
-        getBuckets<T>(st.top(), newBuckets, count);
+            return caseSorted(st, output, index);
+        }
+
+        table.reset(count);
+
+        getBuckets<T>(map, st.top(), table);
 
         st.pop();
 
-        for (int i = newBuckets.size() - 1; i >= 0; --i) {
-            if (newBuckets[i].size() > 0)
+        for (long int i = table.findPrevValue(table.size()); i >= 0; i = table.findPrevValue(i)) {
+            if (table[i].size() > 0)
             {
-                st.emplace(std::move(newBuckets[i]));
+                st.emplace(std::move(table[i]));
             }
         }
         return 0;
@@ -237,51 +237,45 @@ namespace bb_sort {
     };
 
     template<typename Func>
-    Func *const func_array<Func>::switchCase[] = {case1, case2, case3, caseN};
+    Func *const func_array<Func>::switchCase[] = {case1, case2, case3};
 
     template<typename T>
-    void bbSortToStream(STACK &st, std::vector<T> &output, const long int count) {
+    void bbSortToStream(STACK &st, std::vector<T> &output, const long int count, int index = 0) {
 
-        int index = 0;
+        BUCKETS table(0);
 
         while (st.size() > 0 && index < count) {
 
-            const auto caseIndex = std::min(st.top().size() - 1, 3U);
+            const auto size = st.top().size();
+
+            if (size > 3) {
+
+                index += caseN(st, output, index, table);
+                continue;
+            }
+
             const auto switchCaseFunc = func_array<int(
                     STACK &,
                     std::vector<T> &,
                     int)>
-            ::switchCase[caseIndex];
+            ::switchCase[size - 1];
 
             index += switchCaseFunc(st, output, index);
         }
     }
 
-    template<typename T>
-    void  prepareTopBuckets(STACK &st,
-                            BUCKETS &buckets,
-                            std::vector<sort_item<T>> &items,
-                            sort_item<T> &minSortEl,
-                            sort_item<T> &maxSortEl,
-                            int count) {
-
-        float minLog = getLog(&minSortEl);
-        float maxLog = getLog(&maxSortEl);
+    ///Pushes distinct items of counts map with their counts to top buckets.
+    template<typename T, typename Counts>
+    void pushDistinct(const bucket_map<T> &map, const Counts &counts, BUCKETS &buckets) {
 
-        std::tuple<float, float> params = GetLinearTransformParams(minLog, maxLog, 0, count - 1);
-
-        float a = std::get<0>(params);
-        float b = std::get<1>(params);
+        map.forEachIndex(counts.begin(), counts.end(), [](const auto & item) { return item.first; },
+                         [&](const auto & item, int index) { buckets[index].push(item.first, item.second); });
+    }
 
-        //pushing distinct items only
-        for (auto & item : items) {
-            // ApplyLinearTransform
-            int index = ((a * getLog(&item) + b));
-            index = std::min(count - 1, index);
-            buckets[index].push(std::move(item));
-        }
+    template<typename T>
+    void pushTopBuckets(STACK &st, BUCKETS &buckets) {
 
-        for (int i = buckets.size() - 1; i >= 0; --i) {
+        for (long int i = buckets.findPrevValue(buckets.size()); i >= 0; i = buckets.findPrevValue(i)) {
 
             if (buckets[i].size() > 0)
             {
@@ -291,11 +285,43 @@ namespace bb_sort {
     }
 
     template<typename T>
-    void getTopStackBuckets(const std::vector<T> &array,
-                            STACK &st,
+    void  prepareTopBuckets(STACK &st,
                             BUCKETS &buckets,
+                            const robin_hood::unordered_map<T, int> &counts,
+                            const T &minEl,
+                            const T &maxEl,
                             int count) {
 
+        const bucket_map<T> map(minEl, maxEl, count);
+
+        //pushing distinct items only
+        pushDistinct(map, counts, buckets);
+
+        pushTopBuckets<T>(st, buckets);
+    }
+
+    template<typename T>
+    void prepareTopBuckets(STACK &st,
+                           BUCKETS &buckets,
+                           const partitioned_count_map<T> &counts,
+                           const T &minEl,
+                           const T &maxEl,
+                           int count) {
+
+        const bucket_map<T> map(minEl, maxEl, count);
+
+        //distinct items of every partition go to the same buckets, partitions hold disjoint keys.
+        for (const auto & partition : counts.Partitions) {
+
+            pushDistinct(map, partition, buckets);
+        }
+
+        pushTopBuckets<T>(st, buckets);
+    }
+
+    template<typename T>
+    std::tuple<T, T> getMinMax(const std::vector<T> &array) {
+
         T minEl = array[0];
         T maxEl = array[0];
 
@@ -305,29 +331,168 @@ namespace bb_sort {
             maxEl = std::max(item, maxEl);
         }
 
+        return std::make_tuple(minEl, maxEl);
+    }
+
+    ///Counts distinct items into caller owned map, which has to be empty.
+    template<typename T>
+    void getTopStackBuckets(const std::vector<T> &array,
+                            const T &minEl,
+                            const T &maxEl,
+                            STACK &st,
+                            BUCKETS &buckets,
+                            int count,
+                            robin_hood::unordered_map<T, int> &distinctMap) {
+
         // following loop is actual bottleneck: we spent here ~70% of execution time, which depend on size of T.
         // capacity reservation does not help.
 
-        std::vector<sort_item<T>> distinctItems;
+        for (const auto& item: array) {
+
+            distinctMap[item] += 1;
+        }
+
+        prepareTopBuckets(st, buckets, distinctMap, minEl, maxEl, count);
+    }
+
+    template<typename T>
+    void getTopStackBuckets(const std::vector<T> &array,
+                            const T &minEl,
+                            const T &maxEl,
+                            STACK &st,
+                            BUCKETS &buckets,
+                            int count) {
+
         robin_hood::unordered_map<T, int> distinctMap;
 
-        for (const auto& item: array) {
+        getTopStackBuckets(array, minEl, maxEl, st, buckets, count, distinctMap);
+    }
+
+    ///Distinct items are counted by threadCount threads into partitioned map, which feeds top buckets directly.
+    template<typename T>
+    void getTopStackBucketsParallel(const std::vector<T> &array,
+                                    const T &minEl,
+                                    const T &maxEl,
+                                    STACK &st,
+                                    BUCKETS &buckets,
+                                    int count,
+                                    unsigned int threadCount) {
+
+        partitioned_count_map<T> counts(threadCount);
+
+        counts.count(array, threadCount);
+
+        prepareTopBuckets(st, buckets, counts, minEl, maxEl, count);
+    }
+
+    ///Buckets with less distinct items are sorted inline, the rest become work stealing pool tasks.
+    const int parallelTaskMin = 1 << 14;
+
+    template<typename T>
+    void sortBucketParallel(BUCKET &top, std::vector<T> &output, int index, parallel::work_stealing_pool &tasks);
+
+    template<typename T>
+    void flushSmallBuckets(std::vector<BUCKET> &run, std::vector<T> &output, int index) {
+
+        STACK st = makeStack<T>();
+
+        for (int i = run.size() - 1; i >= 0; --i) {
+
+            st.emplace(std::move(run[i]));
+        }
+
+        run.clear();
+
+        bbSortToStream<T>(st, output, output.size(), index);
+    }
+
+    ///Sorts sibling buckets from the stack: large ones are submitted as tasks writing own output range,
+    ///runs of small ones between them are sorted inline.
+    template<typename T>
+    void sortBucketsParallel(STACK &st, std::vector<T> &output, int index, parallel::work_stealing_pool &tasks) {
+
+        std::vector<BUCKET> run;
+        int runIndex = index;
+
+        while (st.size() > 0) {
+
+            const int size = st.top().getTotal();
+
+            if (st.top().size() >= parallelTaskMin) {
+
+                flushSmallBuckets<T>(run, output, runIndex);
+
+                auto bucket = std::make_shared<BUCKET>(std::move(st.top()));
+
+                tasks.submit([bucket, &output, index, &tasks] {
 
-            if (distinctMap.contains(item)) {
+                    sortBucketParallel<T>(*bucket, output, index, tasks);
+                });
 
-                distinctItems[distinctMap[item]].count += 1;
+                runIndex = index + size;
             } else {
 
-                sort_item<T> sortItem(item);
-                distinctItems.emplace_back(sortItem);
-                distinctMap[item] = distinctItems.size() - 1;
+                run.emplace_back(std::move(st.top()));
             }
+
+            st.pop();
+
+            index += size;
+        }
+
+        flushSmallBuckets<T>(run, output, runIndex);
+    }
+
+    template<typename T>
+    void sortBucketParallel(BUCKET &top, std::vector<T> &output, int index, parallel::work_stealing_pool &tasks) {
+
+        if (bb_sort_counting::isDense(top.findMin(), top.findMax(), top.size())) {
+
+            STACK st = makeStack<T>();
+
+            st.emplace(std::move(top));
+
+            caseDense(st, output, index);
+
+            return;
+        }
+
+        int count = (top.size() / 2) + 1;
+
+        count = std::min(count, 128);
+
+        const bucket_map<T> map(top.findMin(), top.findMax(), count);
+
+        if (!map.canSplit()) {
+
+            STACK st = makeStack<T>();
+
+            st.emplace(std::move(top));
+
+            caseSorted(st, output, index);
+
+            return;
         }
 
-        sort_item minSortEl = distinctItems[distinctMap[minEl]];
-        sort_item maxSortEl = distinctItems[distinctMap[maxEl]];
+        BUCKETS newBuckets(count);
+
+        getBuckets<T>(map, top, newBuckets);
+
+        {
+            BUCKET release(std::move(top));
+        }
+
+        STACK st = makeStack<T>();
 
-        prepareTopBuckets(st, buckets, distinctItems, minSortEl, maxSortEl, count);
+        for (long int i = newBuckets.findPrevValue(newBuckets.size()); i >= 0; i = newBuckets.findPrevValue(i)) {
+
+            if (newBuckets[i].size() > 0)
+            {
+                st.emplace(std::move(newBuckets[i]));
+            }
+        }
+
+        sortBucketsParallel<T>(st, output, index, tasks);
     }
 
     template<typename T>
@@ -341,21 +506,89 @@ namespace bb_sort {
         long count = array.size();
         count = std::min(count, 128l);
 
+        const auto [minEl, maxEl] = getMinMax(array);
+
+        if (bb_sort_counting::isDense(minEl, maxEl, array.size())) {
+
+            bb_sort_counting::sort(array.data(), array.data() + array.size(), minEl, maxEl, array.data());
+            return;
+        }
+
         BUCKETS buckets(count);
-        STACK st;
+        STACK st = makeStack<T>();
 
-        getTopStackBuckets(array, st, buckets, count);
+        getTopStackBuckets(array, minEl, maxEl, st, buckets, count);
 
         bbSortToStream(st, array, array.size());
     }
 
+    ///Sorts with scratch arrays and bucket stack allocated from resource, for example pool::sort_arena, instead of global
+    ///array pool and heap. Count map is a robin_hood one, it still allocates from heap.
     template<typename T>
-    std::vector<T> getTopSorted(std::vector<T> &array, long int count) {
+    void sort(std::vector<T> &array, std::pmr::memory_resource * resource) {
+
+        pool::memory_scope scope(resource);
+
+        sort(array);
+    }
+
+    template<typename T>
+    void sortParallel(std::vector<T> &array, unsigned int threadCount = std::thread::hardware_concurrency()) {
+
+        if (array.size() <= 1) {
+
+            return;
+        }
+
+        if (threadCount <= 1 || array.size() < parallelTaskMin) {
+
+            sort(array);
+            return;
+        }
+
+        long count = array.size();
+        count = std::min(count, 128l);
+
+        const auto [minEl, maxEl] = getMinMax(array);
+
+        if (bb_sort_counting::isDense(minEl, maxEl, array.size())) {
+
+            bb_sort_counting::sort(array.data(), array.data() + array.size(), minEl, maxEl, array.data());
+            return;
+        }
+
+        BUCKETS buckets(count);
+        STACK st = makeStack<T>();
+
+        getTopStackBucketsParallel(array, minEl, maxEl, st, buckets, count, threadCount);
+
+        parallel::work_stealing_pool tasks(threadCount);
+
+        sortBucketsParallel<T>(st, array, 0, tasks);
+
+        tasks.wait();
+    }
+
+    ///Scratch of getTopSorted, containers keep their capacity between calls of the owner.
+    template<typename T>
+    struct top_scratch {
+
+        explicit top_scratch(std::pmr::memory_resource * resource = pool::getScopeResource()) : Stack(makeStack<T>(resource)) {
+        }
+
+        STACK Stack;
+        BUCKETS Buckets{0};
+        robin_hood::unordered_map<T, int> Counts;
+    };
+
+    ///Writes count smallest items sorted to result, which is resized to count.
+    template<typename T>
+    void getTopSorted(std::vector<T> &array, long int count, std::vector<T> &result, top_scratch<T> &scratch) {
 
         long int size = array.size();
 
         count = std::min(size, count);
-        std::vector<T> result(count);
+        result.resize(count);
 
         if (size <= 1) {
 
@@ -364,19 +597,45 @@ namespace bb_sort {
                 result[i] = array[i];
             }
 
-            return result;
+            return;
         }
 
         const int bucketCount =  std::min(size, 128l);
 
-        BUCKETS buckets(bucketCount);
-        STACK st;
+        const auto [minEl, maxEl] = getMinMax(array);
+
+        scratch.Buckets.reset(bucketCount);
+        scratch.Counts.clear();
+
+        getTopStackBuckets(array, minEl, maxEl, scratch.Stack, scratch.Buckets, bucketCount, scratch.Counts);
+
+        bbSortToStream<T>(scratch.Stack, result, count);
+
+        //stream stops after count items, buckets left are dropped.
+        while (!scratch.Stack.empty()) {
+
+            scratch.Stack.pop();
+        }
+    }
+
+    template<typename T>
+    std::vector<T> getTopSorted(std::vector<T> &array, long int count) {
 
-        getTopStackBuckets(array, st, buckets, bucketCount);
+        std::vector<T> result;
+        top_scratch<T> scratch;
 
-        bbSortToStream<T>(st, result, count);
+        getTopSorted(array, count, result, scratch);
 
         return result;
     }
+
+    ///Top sorted with scratch arrays and bucket stack allocated from resource, count map still allocates from heap.
+    template<typename T>
+    std::vector<T> getTopSorted(std::vector<T> &array, long int count, std::pmr::memory_resource * resource) {
+
+        pool::memory_scope scope(resource);
+
+        return getTopSorted(array, count);
+    }
 }
 #endif
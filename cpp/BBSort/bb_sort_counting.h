@@ -0,0 +1,63 @@
+#ifndef BBSORT_SOLUTION_BB_SORT_COUNTING_H
+#define BBSORT_SOLUTION_BB_SORT_COUNTING_H
+
+#include "poolable_vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+namespace bb_sort_counting {
+
+    ///Largest histogram used by counting sort, it fits L2 cache.
+    const uint64_t histogramMax = 1 << 16;
+
+    ///Integer range is dense when its histogram is bounded and not larger than the number of items.
+    template<typename T>
+    inline bool isDense(const T & min, const T & max, long int size) {
+
+        if constexpr (std::is_integral_v<T>) {
+
+            const uint64_t range = (uint64_t) max - (uint64_t) min;
+
+            return range < histogramMax && range < (uint64_t) size;
+        } else {
+
+            return false;
+        }
+    }
+
+    ///Counts items by offset from min, then writes them to output in one pass. Output may be the input itself.
+    ///value(item) gives item key of [min, max] range, count(item) gives the number of its copies.
+    ///Items past outputEnd are dropped. Returns the end of written output.
+    template<typename T, typename I, typename Value, typename Count>
+    T * sort(I begin, I end, const T & min, const T & max, T * output, T * outputEnd, Value value, Count count) {
+
+        const int range = (int) ((uint64_t) max - (uint64_t) min) + 1;
+
+        pool::vector<int> counts;
+        counts.reserve(range);
+
+        std::fill(counts.array, counts.array + range, 0);
+
+        for (; begin != end; ++begin) {
+
+            counts.array[(uint64_t) value(*begin) - (uint64_t) min] += count(*begin);
+        }
+
+        for (int i = 0; i < range && output < outputEnd; ++i) {
+
+            output = std::fill_n(output, std::min<long int>(counts.array[i], outputEnd - output), (T) ((uint64_t) min + i));
+        }
+
+        return output;
+    }
+
+    template<typename T>
+    T * sort(const T * begin, const T * end, const T & min, const T & max, T * output) {
+
+        return sort(begin, end, min, max, output, output + (end - begin), [](const T & item) { return item; }, [](const T & item) { return 1; });
+    }
+}
+
+#endif //BBSORT_SOLUTION_BB_SORT_COUNTING_H
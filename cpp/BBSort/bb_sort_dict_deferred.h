@@ -0,0 +1,217 @@
+#ifndef BBSORT_SOLUTION_BB_SORT_DICT_DEFERRED_H
+#define BBSORT_SOLUTION_BB_SORT_DICT_DEFERRED_H
+
+#include "fast_map.h"
+#include "bb_sort.h"
+#include "bb_sort_dictless_min_max_vect.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace bb_sort_dict_deferred {
+
+    ///Largest number of distinct items counted per bucket, counting table of that size stays in L2 cache.
+    const int distinctMax = 1 << 12;
+
+    ///Largest number of buckets a bucket with too many distinct items is split to.
+    const int splitMax = 1024;
+
+    ///Largest number of distinct items sorted by comparisons, fewer than that do not pay for dict buckets.
+    const int sortedMax = 16;
+
+    ///Collapses duplicates of a single bucket, table and dict buckets are reused between buckets.
+    template<typename T>
+    class bucket_counter {
+
+    public:
+
+        robin_hood::unordered_map<T, int> Distinct;
+
+        std::vector<std::pair<T, int>> Items;
+
+        STACK Stack = bb_sort::makeStack<T>();
+        BUCKETS Buckets{0};
+
+        ///Counts distinct items of bucket. Returns false as soon as there are more than distinctMax of them.
+        ///Bucket without repeats counts as many distinct items as its size and keeps splitting as plain items.
+        bool count(const T * items, unsigned int size) {
+
+            Distinct.clear();
+
+            for (unsigned int i = 0; i < size; ++i) {
+
+                const T & item = items[i];
+
+                Distinct[item] += 1;
+
+                if (Distinct.size() > distinctMax) {
+
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    ///Distinct items with counts go through dict engine buckets, every item is written as a run of its count.
+    ///Few distinct items are sorted by comparisons.
+    template<typename T>
+    int caseDistinct(STACK_DM & st,
+                     std::vector<T> & output,
+                     int index,
+                     bucket_counter<T> & counter) {
+
+        const long int top = st.back();
+
+        const T min = st.Mins.array[top];
+        const T max = st.Maxs.array[top];
+
+        const int count = st.count(top);
+
+        st.pop_back();
+
+        if (counter.Distinct.size() <= sortedMax) {
+
+            counter.Items.clear();
+
+            for (const auto & item : counter.Distinct) {
+
+                counter.Items.emplace_back(item.first, item.second);
+            }
+
+            std::sort(counter.Items.begin(), counter.Items.end(), [](const auto & a, const auto & b) { return a.first < b.first; });
+
+            for (const auto & item : counter.Items) {
+
+                index = std::fill_n(output.begin() + index, item.second, item.first) - output.begin();
+            }
+
+            return count;
+        }
+
+        const int bucketCount = std::min<long int>(counter.Distinct.size(), 128);
+
+        counter.Buckets.reset(bucketCount);
+
+        bb_sort::prepareTopBuckets(counter.Stack, counter.Buckets, counter.Distinct, min, max, bucketCount);
+
+        bb_sort::bbSortToStream<T>(counter.Stack, output, index + count, index);
+
+        return count;
+    }
+
+    template<typename T>
+    int caseN(STACK_DM & st,
+              std::vector<T> & output,
+              int index,
+              bucket_counter<T> & counter) {
+
+        const long int top = st.back();
+
+        const T min = st.Mins.array[top];
+        const T max = st.Maxs.array[top];
+
+        const unsigned int size = st.count(top);
+
+        if (min == max) {
+
+            return bb_sort_dictless_min_max_vect::caseAllDuplicates(st, output, index);
+        }
+
+        if (bb_sort_counting::isDense(min, max, size)) {
+
+            return bb_sort_dictless_min_max_vect::caseDense(st, output, index);
+        }
+
+        if (counter.count(st.Items.array[top], size) && counter.Distinct.size() < size) {
+
+            return caseDistinct(st, output, index, counter);
+        }
+
+        if (bb_sort_radix::isLowSpread(min, max, size)) {
+
+            return bb_sort_dictless_min_max_vect::caseRadix(st, output, index);
+        }
+
+        long int count = std::min((size / 2) + 1, (unsigned int) splitMax);
+
+        const bb_sort::bucket_map<T> map(min, max, count);
+
+        if (!map.canSplit()) {
+
+            return bb_sort_dictless_min_max_vect::caseRadix(st, output, index);
+        }
+
+        bb_sort_dictless_min_max_vect::splitBack<T>(st, map, count);
+
+        return 0;
+    }
+
+    ///Buckets hold plain items, duplicates are counted per bucket once it has few enough distinct items,
+    ///so counting table stays small instead of covering the whole input.
+    template<typename T>
+    void bbSortToStream(STACK_DM & st, std::vector<T> & output, int index = 0) {
+
+        bucket_counter<T> counter;
+
+        while (!st.empty()) {
+
+            const unsigned int size = st.count(st.back());
+
+            if (size == 0) {
+
+                st.trimBack();
+                continue;
+            }
+
+            if (size <= 3) {
+
+                const auto switchCaseFunc = bb_sort_dictless_min_max_vect::func_array<int(
+                        STACK_DM &,
+                        std::vector<T> &,
+                        int)>
+                ::switchCase[size - 1];
+
+                index += switchCaseFunc(st, output, index);
+            } else {
+
+                index += caseN(st, output, index, counter);
+            }
+        }
+    }
+
+    template<typename T>
+    void sort(std::vector<T> & array) {
+
+        long int size = array.size();
+
+        if (size <= 1) {
+
+            return;
+        }
+
+        int count = array.size();
+
+        count = std::min(count, 1024);
+
+        STACK_DM st(count);
+
+        bb_sort_dictless_min_max_vect::getTopStackBuckets(array, st, count);
+
+        bbSortToStream<T>(st, array);
+    }
+
+    ///Sorts with scratch arrays and dict bucket stack allocated from resource, for example pool::sort_arena, instead of
+    ///global array pool and heap. Counting table is a robin_hood map, it still allocates from heap.
+    template<typename T>
+    void sort(std::vector<T> & array, std::pmr::memory_resource * resource) {
+
+        pool::memory_scope scope(resource);
+
+        sort(array);
+    }
+}
+
+#endif //BBSORT_SOLUTION_BB_SORT_DICT_DEFERRED_H
@@ -8,35 +8,28 @@
 #define BUCKETS_D pool::vector_lazy<BUCKET_D>
 
 #include "fast_map.h"
+#include "bucket_map.h"
+#include "bb_sort_counting.h"
+#include "bb_sort_heavy_hitters.h"
 #include "poolable_vector.h"
 #include "poolable_vector_lazy.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
 #include <vector>
 #include <tuple>
 #include <cmath>
 #include <stack>
 #include <min_max_heap.h>
 #include <chrono>
+#include <memory>
+#include <thread>
 
 namespace bb_sort_dictless {
 
     template<typename T>
-    void getBuckets(BUCKET_D & iterable, STACK_D & buckets, int count) {
+    void getBuckets(const bb_sort::bucket_map<T> & map, BUCKET_D & iterable, STACK_D & buckets) {
 
-        float minLog = bb_sort::getLog(iterable.findMin());
-        float maxLog = bb_sort::getLog(iterable.findMax());
-
-        std::tuple<float, float> params = bb_sort::GetLinearTransformParams(minLog, maxLog, 0, count - 1);
-
-        float a = std::get<0>(params);
-        float b = std::get<1>(params);
-
-        for(int i = 0; i < iterable.size(); ++i) {
-
-            // ApplyLinearTransform
-            int index = ((a * bb_sort::getLog(iterable.At(i)) + b));
-            index = std::min(count - 1, index);
-            buckets[index].push(iterable.At(i));
-        }
+        map.forEachIndex(iterable.begin(), iterable.size(), [&](const T & item, int index) { buckets[index].push(item); });
     }
 
     template<typename T>
@@ -59,6 +52,21 @@ namespace bb_sort_dictless {
         return count;
     }
 
+    template<typename T>
+    int caseDense(STACK_D & st,
+                  BUCKET_D & top,
+                  std::vector<T> & output,
+                  int index) {
+
+        auto count = top.size();
+
+        bb_sort_counting::sort(top.begin(), top.end(), top.findMin(), top.findMax(), output.data() + index);
+
+        st.pop_back();
+
+        return count;
+    }
+
     template<typename T>
     int case1(STACK_D & st,
               BUCKET_D & top,
@@ -104,31 +112,59 @@ namespace bb_sort_dictless {
         return 3;
     }
 
+    ///Bucket map can not split items of the bucket apart, they are sorted by comparisons.
+    template<typename T>
+    int caseSorted(STACK_D & st,
+                   BUCKET_D & top,
+                   std::vector<T> & output,
+                   int index) {
+
+        auto count = top.size();
+
+        std::copy(top.begin(), top.end(), output.begin() + index);
+        std::sort(output.begin() + index, output.begin() + index + count);
+
+        st.pop_back();
+
+        return count;
+    }
+
+    ///Table is recycled between splits of a sort: children are moved out to stack before the next split resets it.
     template<typename T>
     int caseN(STACK_D & st,
               BUCKET_D & top,
               std::vector<T> & output,
-              int index) {
+              int index,
+              BUCKETS_D & table) {
 
         if (top.allDuplicates()) {
 
             return caseAllDuplicates(st, top, output, index);
         }
 
+        if (bb_sort_counting::isDense(top.findMin(), top.findMax(), top.size())) {
+
+            return caseDense(st, top, output, index);
+        }
+
         long int count = (top.size() / 2) + 1;
 
-        BUCKETS_D newBuckets(count);
+        const bb_sort::bucket_map<T> map(top.findMin(), top.findMax(), count);
 
-        getBuckets<T>(top, newBuckets, count);
+        if (!map.canSplit()) {
 
-        st.pop_back();
+            return caseSorted(st, top, output, index);
+        }
 
-        for (int i = newBuckets.size() - 1; i >= 0; --i) {
+        table.reset(count);
 
-            if (newBuckets.hasValue(i)) {
+        bb_sort_dictless::getBuckets<T>(map, top, table);
 
-                st.emplace_back(std::move(newBuckets[i]));
-            }
+        st.pop_back();
+
+        for (long int i = table.findPrevValue(table.size()); i >= 0; i = table.findPrevValue(i)) {
+
+            st.emplace_back(std::move(table[i]));
         }
 
         return 0;
@@ -140,35 +176,42 @@ namespace bb_sort_dictless {
     };
 
     template<typename Func>
-    Func *const func_array<Func>::switchCase[] = {case1, case2, case3, caseN};
+    Func *const func_array<Func>::switchCase[] = {case1, case2, case3};
 
     template<typename T>
-    void bbSortToStream(STACK_D & st, std::vector<T> & output, const long int count) {
+    void bbSortToStream(STACK_D & st, std::vector<T> & output, const long int count, int index = 0) {
 
-        int index = 0;
+        BUCKETS_D table(0);
 
         while (!st.empty()) {
 
             if (st.hasBack()) {
 
-                const auto caseIndex = std::min(st.back().size() - 1, 3U);
+                BUCKET_D & top = st.back();
+
+                if (top.size() > 3) {
+
+                    index += caseN(st, top, output, index, table);
+                    continue;
+                }
+
                 const auto switchCaseFunc = func_array<int(
                         STACK_D &,
                         BUCKET_D &,
                         std::vector<T> &,
                         int)>
-                ::switchCase[caseIndex];
+                ::switchCase[top.size() - 1];
 
-                index += switchCaseFunc(st, st.back(), output, index);
+                index += switchCaseFunc(st, top, output, index);
             } else {
 
-                st.pop_back();
+                st.trimBack();
             }
         }
     }
 
     template<typename T>
-    void getTopStackBuckets(std::vector<T> & array, STACK_D & st, int count) {
+    void getTopStackBuckets(std::vector<T> & array, STACK_D & st, int count, bb_sort_heavy::segments<T, STACK_D> * heavy = nullptr) {
 
         T min = array[0];
         T max = array[0];
@@ -184,18 +227,121 @@ namespace bb_sort_dictless {
             return;
         }
 
-        const std::tuple<float, float> params = bb_sort::GetLinearTransformParams(bb_sort::getLog(min), bb_sort::getLog(max), 0, count - 1);
+        if (bb_sort_counting::isDense(min, max, array.size())) {
+
+            //dense range is sorted in place by counting, stack stays empty.
+            bb_sort_counting::sort(array.data(), array.data() + array.size(), min, max, array.data());
+            return;
+        }
+
+        const bb_sort::bucket_map<T> map(min, max, count);
+
+        if (heavy != nullptr && heavy->detect(array.data(), array.size(), count)) {
+
+            //heavy hitters are counted instead of being scattered, items go to segment stacks.
+            heavy->scatter(array.data(), array.size(), map, count);
+            return;
+        }
+
+        map.forEachIndex(array.data(), array.size(), [&](const T & item, int index) { st[count - index - 1].push(item); });
+    }
+
+    ///Buckets smaller than this one are sorted inline, the rest become work stealing pool tasks.
+    const int parallelTaskMin = 1 << 14;
+
+    template<typename T>
+    void sortBucketParallel(BUCKET_D & top, std::vector<T> & output, int index, parallel::work_stealing_pool & tasks);
+
+    template<typename T>
+    void flushSmallBuckets(BUCKETS_D & buckets, int from, int to, bool stackOrder, std::vector<T> & output, int index) {
+
+        if (from >= to) {
+
+            return;
+        }
+
+        STACK_D st(0);
+
+        for (int i = to - 1; i >= from; --i) {
+
+            int slot = stackOrder ? buckets.size() - 1 - i : i;
+
+            if (buckets.hasValue(slot)) {
+
+                st.emplace_back(std::move(buckets[slot]));
+            }
+        }
+
+        bbSortToStream<T>(st, output, 0, index);
+    }
+
+    ///Sorts sibling buckets: large ones are submitted as tasks writing own output range,
+    ///runs of small ones between them are sorted inline.
+    template<typename T>
+    void sortBucketsParallel(BUCKETS_D & buckets, bool stackOrder, std::vector<T> & output, int index, parallel::work_stealing_pool & tasks) {
+
+        int runFrom = 0;
+        int runIndex = index;
+
+        for (int i = 0; i < buckets.size(); ++i) {
+
+            int slot = stackOrder ? buckets.size() - 1 - i : i;
+
+            if (!buckets.hasValue(slot)) {
+
+                continue;
+            }
+
+            int size = buckets[slot].size();
+
+            if (size >= parallelTaskMin) {
+
+                flushSmallBuckets<T>(buckets, runFrom, i, stackOrder, output, runIndex);
+
+                auto bucket = std::make_shared<BUCKET_D>(std::move(buckets[slot]));
+
+                tasks.submit([bucket, &output, index, &tasks] {
+
+                    sortBucketParallel<T>(*bucket, output, index, tasks);
+                });
+
+                runFrom = i + 1;
+                runIndex = index + size;
+            }
+
+            index += size;
+        }
+
+        flushSmallBuckets<T>(buckets, runFrom, buckets.size(), stackOrder, output, runIndex);
+    }
+
+    template<typename T>
+    void sortBucketParallel(BUCKET_D & top, std::vector<T> & output, int index, parallel::work_stealing_pool & tasks) {
+
+        long int count = (top.size() / 2) + 1;
+
+        const bb_sort::bucket_map<T> map(top.findMin(), top.findMax(), count);
+
+        if (top.allDuplicates() || bb_sort_counting::isDense(top.findMin(), top.findMax(), top.size()) || !map.canSplit()) {
+
+            STACK_D st(0);
 
-        const float a = std::get<0>(params);
-        const float b = std::get<1>(params);
+            st.emplace_back(std::move(top));
 
-        for(int i = 0; i < array.size(); ++i) {
+            bbSortToStream<T>(st, output, 0, index);
 
-            // ApplyLinearTransform
-            int index = ((a * bb_sort::getLog(array[i]) + b));
-            int stackIndex = count - std::min(count - 1, index) - 1;
-            st[stackIndex].push(array[i]);
+            return;
+        }
+
+        BUCKETS_D newBuckets(count);
+
+        bb_sort_dictless::getBuckets<T>(map, top, newBuckets);
+
+        {
+            BUCKET_D release(std::move(top));
         }
+
+        sortBucketsParallel<T>(newBuckets, false, output, index, tasks);
     }
 
     template<typename T>
@@ -214,9 +360,63 @@ namespace bb_sort_dictless {
 
         STACK_D st(count);
 
-        getTopStackBuckets(array, st, count);
+        bb_sort_heavy::segments<T, STACK_D> heavy;
+
+        getTopStackBuckets(array, st, count, &heavy);
+
+        if (!heavy.empty()) {
+
+            heavy.write(array, [&](STACK_D & segment, int index) { bbSortToStream<T>(segment, array, 0, index); });
+            return;
+        }
 
         bbSortToStream<T>(st, array, size);
     }
+
+    ///Sorts with scratch arrays allocated from resource, for example pool::sort_arena, instead of global array pool.
+    template<typename T>
+    void sort(std::vector<T> & array, std::pmr::memory_resource * resource) {
+
+        pool::memory_scope scope(resource);
+
+        sort(array);
+    }
+
+    template<typename T>
+    void sortParallel(std::vector<T> & array, unsigned int threadCount = std::thread::hardware_concurrency()) {
+
+        long int size = array.size();
+
+        if (size <= 1) {
+
+            return;
+        }
+
+        if (threadCount <= 1 || size < parallelTaskMin) {
+
+            sort(array);
+            return;
+        }
+
+        int count = std::min(size, 128l);
+
+        STACK_D st(count);
+
+        bb_sort_heavy::segments<T, STACK_D> heavy;
+
+        getTopStackBuckets(array, st, count, &heavy);
+
+        parallel::work_stealing_pool tasks(threadCount);
+
+        if (!heavy.empty()) {
+
+            heavy.write(array, [&](STACK_D & segment, int index) { sortBucketsParallel<T>(segment, true, array, index, tasks); });
+        } else {
+
+            sortBucketsParallel<T>(st, true, array, 0, tasks);
+        }
+
+        tasks.wait();
+    }
 }
 #endif //BBSORT_SOLUTION_BB_SORT_DICTLESS_H
@@ -1,49 +1,56 @@
 #ifndef BBSORT_SOLUTION_BB_SORT_DICTLESS_MIN_MAX_VECT_H
 #define BBSORT_SOLUTION_BB_SORT_DICTLESS_MIN_MAX_VECT_H
 
-#define BUCKET_DM  minmax::min_max_mid_vector<T, pool::vector<T>>
-#define STACK_DM   pool::vector_lazy<BUCKET_DM>
-#define BUCKETS_DM pool::vector_lazy<BUCKET_DM>
+#define STACK_DM   minmax::bucket_stack<T>
 
 #include "fast_map.h"
+#include "bucket_map.h"
+#include "bb_sort_counting.h"
+#include "bb_sort_radix.h"
+#include "bb_sort_heavy_hitters.h"
+#include "cdf_bucket_map.h"
 #include "poolable_vector.h"
-#include "poolable_vector_lazy.h"
-#include "min_max_mid_vector.h"
+#include "bucket_stack.h"
+#include "work_stealing_pool.h"
 
 #include <vector>
 #include <tuple>
 #include <cmath>
+#include <memory>
+#include <thread>
 
 namespace bb_sort_dictless_min_max_vect {
 
+    ///Replaces back bucket by count child buckets in stack order, so the first child is on top.
     template<typename T>
-    void getBuckets(BUCKET_DM & minMaxVector, float minLog, float maxLog, STACK_DM & buckets, int count) {
+    void splitBack(STACK_DM & st, const bb_sort::bucket_map<T> & map, long int count) {
 
-        std::tuple<float, float> params = bb_sort::GetLinearTransformParams(minLog, maxLog, 0, count - 1);
+        unsigned int size;
+        unsigned int capacity;
 
-        float a = std::get<0>(params);
-        float b = std::get<1>(params);
+        T * items = st.detachBack(size, capacity);
 
-        for(int i = 0; i < minMaxVector.size(); ++i) {
+        const long int top = st.size() + count - 1;
 
-            // ApplyLinearTransform
-            int index = ((a * bb_sort::getLog(minMaxVector.Storage[i]) + b));
-            index = std::min(count - 1, index);
-            buckets[index].push(minMaxVector.Storage[i]);
-        }
+        st.pushEmpty(count);
+
+        map.forEachIndex(items, size, [&](const T & item, int index) { st.push(top - index, item); });
+
+        st.releaseArray(items, capacity);
     }
 
     template<typename T>
     int caseAllDuplicates(STACK_DM & st,
-                          BUCKET_DM & top,
                           std::vector<T> & output,
                           int index) {
 
-        auto count = top.size();
+        const long int top = st.back();
+
+        auto count = st.count(top);
 
         for (int i = 0; i < count; ++i) {
 
-            output[index + i] = top.Min;
+            output[index + i] = st.Mins.array[top];
         }
 
         st.pop_back();
@@ -51,13 +58,51 @@ namespace bb_sort_dictless_min_max_vect {
         return count;
     }
 
+    template<typename T>
+    int caseDense(STACK_DM & st,
+                  std::vector<T> & output,
+                  int index) {
+
+        const long int top = st.back();
+
+        auto count = st.count(top);
+
+        bb_sort_counting::sort(st.Items.array[top], st.Items.array[top] + count, st.Mins.array[top], st.Maxs.array[top], output.data() + index);
+
+        st.pop_back();
+
+        return count;
+    }
+
+    ///Output range of the bucket is used as radix sort scratch buffer.
+    template<typename T>
+    int caseRadix(STACK_DM & st,
+                  std::vector<T> & output,
+                  int index) {
+
+        const long int top = st.back();
+
+        auto size = st.count(top);
+
+        T * begin = output.data() + index;
+        T * sorted = bb_sort_radix::sort(st.Items.array[top], begin, size, st.Mins.array[top], st.Maxs.array[top]);
+
+        if (sorted != begin) {
+
+            std::copy(sorted, sorted + size, begin);
+        }
+
+        st.pop_back();
+
+        return size;
+    }
+
     template<typename T>
     int case1(STACK_DM & st,
-              BUCKET_DM & top,
               std::vector<T> & output,
               int index) {
 
-        output[index] = top.Min;
+        output[index] = st.Mins.array[st.back()];
 
         st.pop_back();
 
@@ -66,12 +111,13 @@ namespace bb_sort_dictless_min_max_vect {
 
     template<typename T>
     int case2(STACK_DM & st,
-              BUCKET_DM & top,
               std::vector<T> & output,
               int index) {
 
-        output[index]     = top.Min;
-        output[index + 1] = top.Max;
+        const long int top = st.back();
+
+        output[index]     = st.Mins.array[top];
+        output[index + 1] = st.Maxs.array[top];
 
         st.pop_back();
 
@@ -80,13 +126,14 @@ namespace bb_sort_dictless_min_max_vect {
 
     template<typename T>
     int case3(STACK_DM & st,
-              BUCKET_DM & top,
               std::vector<T> & output,
               int index) {
 
-        output[index]     = top.Min;
-        output[index + 1] = top.Mid;
-        output[index + 2] = top.Max;
+        const long int top = st.back();
+
+        output[index]     = st.Mins.array[top];
+        output[index + 1] = st.Mids.array[top];
+        output[index + 2] = st.Maxs.array[top];
 
         st.pop_back();
 
@@ -95,50 +142,42 @@ namespace bb_sort_dictless_min_max_vect {
 
     template<typename T>
     int caseN(STACK_DM & st,
-              BUCKET_DM & top,
               std::vector<T> & output,
               int index) {
 
-        float minLog = bb_sort::getLog(top.Min);
-        float maxLog = bb_sort::getLog(top.Max);
-
-        if(maxLog - minLog < 0.1){
-
-            if (top.Max == top.Min) {
-
-                return caseAllDuplicates(st, top, output, index);
-            }
-
-            std::sort (top.Storage.begin(), top.Storage.end());
+        const long int top = st.back();
 
-            auto count = top.size();
+        const T min = st.Mins.array[top];
+        const T max = st.Maxs.array[top];
 
-            for (int i = 0; i < count; ++i) {
+        const unsigned int size = st.count(top);
 
-                output[index + i] = top.Storage.at(i);
-            }
-
-            st.pop_back();
+        if (bb_sort_counting::isDense(min, max, size)) {
 
-            return count;
+            return caseDense(st, output, index);
         }
 
-        long int count = (top.size() / 2) + 1;
+        if (bb_sort_radix::isLowSpread(min, max, size)) {
 
-        BUCKETS_DM newBuckets(count);
+            return caseRadix(st, output, index);
+        }
 
-        getBuckets<T>(top, minLog, maxLog, newBuckets, count);
+        long int count = (size / 2) + 1;
 
-        st.pop_back();
+        const bb_sort::bucket_map<T> map(min, max, count);
 
-        for (int i = newBuckets.size() - 1; i >= 0; --i) {
+        if(!map.canSplit()){
 
-            if (newBuckets.hasValue(i)) {
+            if (max == min) {
 
-                st.emplace_back(std::move(newBuckets[i]));
+                return caseAllDuplicates(st, output, index);
             }
+
+            return caseRadix(st, output, index);
         }
 
+        splitBack<T>(st, map, count);
+
         return 0;
     }
 
@@ -151,32 +190,30 @@ namespace bb_sort_dictless_min_max_vect {
     Func *const func_array<Func>::switchCase[] = {case1, case2, case3, caseN};
 
     template<typename T>
-    void bbSortToStream(STACK_DM & st, std::vector<T> & output, const long int count) {
-
-        int index = 0;
+    void bbSortToStream(STACK_DM & st, std::vector<T> & output, const long int count, int index = 0) {
 
         while (!st.empty()) {
 
-            if (st.hasBack()) {
+            if (st.count(st.back()) > 0) {
 
-                const auto caseIndex = std::min(st.back().size() - 1, 3U);
+                const auto caseIndex = std::min(st.count(st.back()) - 1, 3U);
                 const auto switchCaseFunc = func_array<int(
                         STACK_DM &,
-                        BUCKET_DM &,
                         std::vector<T> &,
                         int)>
                 ::switchCase[caseIndex];
 
-                index += switchCaseFunc(st, st.back(), output, index);
+                index += switchCaseFunc(st, output, index);
             } else {
 
-                st.pop_back();
+                st.trimBack();
             }
         }
     }
 
     template<typename T>
-    void getTopStackBuckets(std::vector<T> & array, STACK_DM & st, int count) {
+    void getTopStackBuckets(std::vector<T> & array, STACK_DM & st, int count, bb_sort::top_mapping mapping = bb_sort::top_mapping::Keys,
+                            bb_sort_heavy::segments<T, STACK_DM> * heavy = nullptr) {
 
         T min = array[0];
         T max = array[0];
@@ -192,22 +229,205 @@ namespace bb_sort_dictless_min_max_vect {
             return;
         }
 
-        const std::tuple<float, float> params = bb_sort::GetLinearTransformParams(bb_sort::getLog(min), bb_sort::getLog(max), 0, count - 1);
+        if (bb_sort_counting::isDense(min, max, array.size())) {
+
+            //dense range is sorted in place by counting, stack stays empty.
+            bb_sort_counting::sort(array.data(), array.data() + array.size(), min, max, array.data());
+            return;
+        }
+
+        //heavy hitters are counted instead of being scattered, items go to segment stacks.
+        const bool heavyHitters = heavy != nullptr && heavy->detect(array.data(), array.size(), count);
+
+        auto scatter = [&](const auto & map) {
+
+            if (heavyHitters) {
+
+                heavy->scatter(array.data(), array.size(), map, count);
+                return;
+            }
+
+            map.forEachIndex(array.data(), array.size(), [&](const T & item, int index) { st.push(count - index - 1, item); });
+        };
+
+        if constexpr (bb_sort_radix::hasKey<T>) {
+
+            if (mapping == bb_sort::top_mapping::Cdf) {
+
+                scatter(bb_sort::cdf_bucket_map<T>(array.data(), array.size(), min, max, count));
+                return;
+            }
+        }
+
+        scatter(bb_sort::bucket_map<T>(min, max, count));
+    }
+
+    ///Minimal slice of input processed by a single thread in parallel mode.
+    const int parallelSliceMin = 1 << 15;
+
+    template<typename T>
+    void getTopStackBucketsParallel(std::vector<T> & array, STACK_DM & st, int count, unsigned int threadCount) {
+
+        std::vector<T> mins(threadCount);
+        std::vector<T> maxs(threadCount);
+
+        parallel::forEachSlice(array.size(), threadCount, [&](unsigned int t, long int begin, long int end) {
+
+            T min = array[begin];
+            T max = array[begin];
+
+            for(long int i = begin + 1; i < end; ++i){
+
+                min = std::min(min, array[i]);
+                max = std::max(max, array[i]);
+            }
+
+            mins[t] = min;
+            maxs[t] = max;
+        });
+
+        const T min = *std::min_element(mins.begin(), mins.end());
+        const T max = *std::max_element(maxs.begin(), maxs.end());
+
+        if (min == max) {
+
+            return;
+        }
+
+        if (bb_sort_counting::isDense(min, max, array.size())) {
+
+            //dense range is sorted in place by counting, stack stays empty.
+            bb_sort_counting::sort(array.data(), array.data() + array.size(), min, max, array.data());
+            return;
+        }
+
+        const bb_sort::bucket_map<T> map(min, max, count);
 
-        const float a = std::get<0>(params);
-        const float b = std::get<1>(params);
+        //each thread scatters own slice into own bucket set, threads rent storage from own pools.
+        std::vector<std::unique_ptr<STACK_DM>> threadBuckets;
 
-        for(int i = 0; i < array.size(); ++i) {
+        for (unsigned int t = 0; t < threadCount; ++t) {
 
-            // ApplyLinearTransform
-            int index = ((a * bb_sort::getLog(array[i]) + b));
-            int stackIndex = count - std::min(count - 1, index) - 1;
-            st[stackIndex].push(array[i]);
+            threadBuckets.emplace_back(std::make_unique<STACK_DM>(count));
         }
+
+        parallel::forEachSlice(array.size(), threadCount, [&](unsigned int t, long int begin, long int end) {
+
+            STACK_DM & buckets = *threadBuckets[t];
+
+            map.forEachIndex(array.data() + begin, end - begin, [&](const T & item, int index) { buckets.push(count - index - 1, item); });
+        });
+
+        //combining in slice order keeps the same items order as single threaded scatter, threads write own slots only.
+        parallel::forEachSlice(count, threadCount, [&](unsigned int t, long int begin, long int end) {
+
+            for (long int i = begin; i < end; ++i) {
+
+                for (unsigned int s = 0; s < threadCount; ++s) {
+
+                    st.append(i, *threadBuckets[s], i);
+                }
+            }
+        });
     }
 
+    ///Buckets smaller than this one are sorted inline, the rest become work stealing pool tasks.
+    const int parallelTaskMin = 1 << 14;
+
+    template<typename T>
+    void sortBucketParallel(STACK_DM & top, std::vector<T> & output, int index, parallel::work_stealing_pool & tasks);
+
+    ///Moves buckets from stack order position from up to to into own stack and sorts them.
     template<typename T>
-    void sort(std::vector<T> & array) {
+    void flushSmallBuckets(STACK_DM & buckets, long int from, long int to, std::vector<T> & output, int index) {
+
+        if (from >= to) {
+
+            return;
+        }
+
+        STACK_DM st;
+
+        for (long int i = to - 1; i >= from; --i) {
+
+            long int slot = buckets.size() - 1 - i;
+
+            if (buckets.count(slot) > 0) {
+
+                buckets.moveSlot(slot, st);
+            }
+        }
+
+        bbSortToStream<T>(st, output, 0, index);
+    }
+
+    ///Sorts sibling buckets in stack order: large ones are submitted as tasks writing own output range,
+    ///runs of small ones between them are sorted inline.
+    template<typename T>
+    void sortBucketsParallel(STACK_DM & buckets, std::vector<T> & output, int index, parallel::work_stealing_pool & tasks) {
+
+        long int runFrom = 0;
+        int runIndex = index;
+
+        for (long int i = 0; i < buckets.size(); ++i) {
+
+            long int slot = buckets.size() - 1 - i;
+
+            int size = buckets.count(slot);
+
+            if (size == 0) {
+
+                continue;
+            }
+
+            if (size >= parallelTaskMin) {
+
+                flushSmallBuckets<T>(buckets, runFrom, i, output, runIndex);
+
+                auto bucket = std::make_shared<STACK_DM>();
+
+                buckets.moveSlot(slot, *bucket);
+
+                tasks.submit([bucket, &output, index, &tasks] {
+
+                    sortBucketParallel<T>(*bucket, output, index, tasks);
+                });
+
+                runFrom = i + 1;
+                runIndex = index + size;
+            }
+
+            index += size;
+        }
+
+        flushSmallBuckets<T>(buckets, runFrom, buckets.size(), output, runIndex);
+    }
+
+    ///Sorts stack of a single bucket, bucket is split into children sorted by sortBucketsParallel.
+    template<typename T>
+    void sortBucketParallel(STACK_DM & top, std::vector<T> & output, int index, parallel::work_stealing_pool & tasks) {
+
+        const long int slot = top.back();
+
+        long int count = (top.count(slot) / 2) + 1;
+
+        const bb_sort::bucket_map<T> map(top.Mins.array[slot], top.Maxs.array[slot], count);
+
+        if(!map.canSplit() || bb_sort_counting::isDense(top.Mins.array[slot], top.Maxs.array[slot], top.count(slot))){
+
+            bbSortToStream<T>(top, output, 0, index);
+
+            return;
+        }
+
+        splitBack<T>(top, map, count);
+
+        sortBucketsParallel<T>(top, output, index, tasks);
+    }
+
+    ///Sorts with caller owned stack and segments, they are reset and keep their arrays for the next sort.
+    template<typename T>
+    void sort(std::vector<T> & array, STACK_DM & st, bb_sort_heavy::segments<T, STACK_DM> & heavy, bb_sort::top_mapping mapping = bb_sort::top_mapping::Keys) {
 
         long int size = array.size();
 
@@ -220,11 +440,67 @@ namespace bb_sort_dictless_min_max_vect {
 
         count = std::min(count, 1024);
 
-        STACK_DM st(count);
+        st.reset(count);
 
-        getTopStackBuckets(array, st, count);
+        getTopStackBuckets(array, st, count, mapping, &heavy);
+
+        if (!heavy.empty()) {
+
+            heavy.write(array, [&](STACK_DM & segment, int index) { bbSortToStream<T>(segment, array, 0, index); });
+            return;
+        }
 
         bbSortToStream<T>(st, array, size);
     }
+
+    template<typename T>
+    void sort(std::vector<T> & array, bb_sort::top_mapping mapping = bb_sort::top_mapping::Keys) {
+
+        STACK_DM st;
+
+        bb_sort_heavy::segments<T, STACK_DM> heavy;
+
+        sort(array, st, heavy, mapping);
+    }
+
+    ///Sorts with scratch arrays allocated from resource, for example pool::sort_arena, instead of global array pool.
+    template<typename T>
+    void sort(std::vector<T> & array, std::pmr::memory_resource * resource, bb_sort::top_mapping mapping = bb_sort::top_mapping::Keys) {
+
+        pool::memory_scope scope(resource);
+
+        sort(array, mapping);
+    }
+
+    template<typename T>
+    void sortParallel(std::vector<T> & array, unsigned int threadCount = std::thread::hardware_concurrency()) {
+
+        long int size = array.size();
+
+        if (size <= 1) {
+
+            return;
+        }
+
+        threadCount = std::max(1l, std::min((long int) threadCount, size / parallelSliceMin));
+
+        if (threadCount == 1) {
+
+            sort(array);
+            return;
+        }
+
+        int count = std::min(size, 1024l);
+
+        STACK_DM st(count);
+
+        getTopStackBucketsParallel(array, st, count, threadCount);
+
+        parallel::work_stealing_pool tasks(threadCount);
+
+        sortBucketsParallel<T>(st, array, 0, tasks);
+
+        tasks.wait();
+    }
 }
 #endif //BBSORT_SOLUTION_BB_SORT_DICTLESS_MIN_MAX_VECT_H
@@ -0,0 +1,238 @@
+#ifndef BBSORT_SOLUTION_BB_SORT_DICTLESS_PREFIX_SUM_H
+#define BBSORT_SOLUTION_BB_SORT_DICTLESS_PREFIX_SUM_H
+
+#include "poolable_vector.h"
+#include "bucket_map.h"
+#include "bb_sort_counting.h"
+#include "bb_sort_radix.h"
+
+#include <vector>
+#include <tuple>
+#include <cmath>
+#include <algorithm>
+
+namespace bb_sort_dictless_prefix_sum {
+
+    ///Bucket is a slice of the input or scratch buffer, both buffers use the same offsets.
+    template<typename T>
+    struct bucket_slice {
+
+        int Offset;
+        int Length;
+
+        T Min;
+        T Max;
+
+        bool InScratch;
+    };
+
+    ///Bucket tables rented once and reused by every scatter, they grow up to the largest bucket count.
+    template<typename T>
+    struct scatter_tables {
+
+        pool::vector<int> Counts;
+        pool::vector<T> Mins;
+        pool::vector<T> Maxs;
+
+        void reserve(int count) {
+
+            Counts.reserve(count);
+            Mins.reserve(count);
+            Maxs.reserve(count);
+        }
+    };
+
+    ///Counts bucket sizes first, then moves every item of the slice to its final bucket position in dst.
+    template<typename T>
+    void scatter(const T * src,
+                 T * dst,
+                 bucket_slice<T> & slice,
+                 int count,
+                 scatter_tables<T> & tables,
+                 pool::vector<bucket_slice<T>> & st) {
+
+        const bb_sort::bucket_map<T> map(slice.Min, slice.Max, count);
+
+        tables.reserve(count);
+
+        int * counts = tables.Counts.array;
+        T * mins = tables.Mins.array;
+        T * maxs = tables.Maxs.array;
+
+        std::fill(counts, counts + count, 0);
+
+        map.forEachIndex(src + slice.Offset, slice.Length, [&](const T & item, int index) {
+
+            if (counts[index] == 0) {
+
+                mins[index] = item;
+                maxs[index] = item;
+            } else {
+
+                mins[index] = std::min(mins[index], item);
+                maxs[index] = std::max(maxs[index], item);
+            }
+
+            ++counts[index];
+        });
+
+        //exclusive prefix sum turns counts into bucket starts, they become bucket ends after the second pass.
+        int offset = slice.Offset;
+
+        for (int i = 0; i < count; ++i) {
+
+            const int length = counts[i];
+            counts[i] = offset;
+            offset += length;
+        }
+
+        //second pass maps items again by the same kernel instead of keeping an index per item.
+        map.forEachIndex(src + slice.Offset, slice.Length, [&](const T & item, int index) {
+
+            dst[counts[index]++] = item;
+        });
+
+        const bool inScratch = !slice.InScratch;
+
+        for (int i = count - 1; i >= 0; --i) {
+
+            const int begin = i == 0 ? slice.Offset : counts[i - 1];
+            const int length = counts[i] - begin;
+
+            if (length > 0) {
+
+                st.push_back(bucket_slice<T> {begin, length, mins[i], maxs[i], inScratch});
+            }
+        }
+    }
+
+    template<typename T>
+    void sortSlice(std::vector<T> & output,
+                   pool::vector<T> & scratch,
+                   bucket_slice<T> & slice,
+                   scatter_tables<T> & tables,
+                   pool::vector<bucket_slice<T>> & st) {
+
+        T * src = slice.InScratch ? scratch.array : output.data();
+        const int offset = slice.Offset;
+
+        switch (slice.Length) {
+
+            case 1:
+
+                output[offset] = slice.Min;
+                return;
+
+            case 2:
+
+                output[offset]     = slice.Min;
+                output[offset + 1] = slice.Max;
+                return;
+
+            case 3: {
+
+                const T a = src[offset], b = src[offset + 1], c = src[offset + 2];
+
+                output[offset]     = slice.Min;
+                output[offset + 1] = std::max(std::min(a, b), std::min(std::max(a, b), c));
+                output[offset + 2] = slice.Max;
+                return;
+            }
+        }
+
+        if (slice.Min == slice.Max) {
+
+            std::fill(output.begin() + offset, output.begin() + offset + slice.Length, slice.Min);
+            return;
+        }
+
+        if (bb_sort_counting::isDense(slice.Min, slice.Max, slice.Length)) {
+
+            bb_sort_counting::sort(src + offset, src + offset + slice.Length, slice.Min, slice.Max, output.data() + offset);
+            return;
+        }
+
+        T * dst = slice.InScratch ? output.data() : scratch.array;
+
+        const int count = (slice.Length / 2) + 1;
+
+        const bb_sort::bucket_map<T> map(slice.Min, slice.Max, count);
+
+        if (!map.canSplit() || bb_sort_radix::isLowSpread(slice.Min, slice.Max, slice.Length)) {
+
+            //other buffer slice is radix sort scratch.
+            T * sorted = bb_sort_radix::sort(src + offset, dst + offset, slice.Length, slice.Min, slice.Max);
+
+            if (sorted != output.data() + offset) {
+
+                std::copy(sorted, sorted + slice.Length, output.begin() + offset);
+            }
+            return;
+        }
+
+        scatter(src, dst, slice, count, tables, st);
+    }
+
+    template<typename T>
+    void sort(std::vector<T> & array) {
+
+        long int size = array.size();
+
+        if (size <= 1) {
+
+            return;
+        }
+
+        T min = array[0];
+        T max = array[0];
+
+        for(int i = 1; i < array.size(); ++i){
+
+            min = std::min(min, array[i]);
+            max = std::max(max, array[i]);
+        }
+
+        if (min == max) {
+
+            return;
+        }
+
+        if (bb_sort_counting::isDense(min, max, size)) {
+
+            bb_sort_counting::sort(array.data(), array.data() + size, min, max, array.data());
+            return;
+        }
+
+        int count = std::min(size, 1024l);
+
+        pool::vector<T> scratch;
+        scratch.reserve(size);
+
+        scatter_tables<T> tables;
+
+        pool::vector<bucket_slice<T>> st;
+
+        bucket_slice<T> top {0, (int) size, min, max, false};
+
+        scatter(array.data(), scratch.array, top, count, tables, st);
+
+        while (!st.empty()) {
+
+            bucket_slice<T> slice = st.back();
+            st.pop_back();
+
+            sortSlice(array, scratch, slice, tables, st);
+        }
+    }
+
+    ///Sorts with scratch arrays allocated from resource, for example pool::sort_arena, instead of global array pool.
+    template<typename T>
+    void sort(std::vector<T> & array, std::pmr::memory_resource * resource) {
+
+        pool::memory_scope scope(resource);
+
+        sort(array);
+    }
+}
+
+#endif //BBSORT_SOLUTION_BB_SORT_DICTLESS_PREFIX_SUM_H
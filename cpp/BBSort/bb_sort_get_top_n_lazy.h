@@ -22,22 +22,9 @@
 namespace bb_sort_top_n_lazy {
 
     template<typename T>
-    void getBuckets(const BUCKET_TOPN &iterable, BUCKETS_TOPN &buckets, int count) {
+    void getBuckets(const bb_sort::bucket_map<T> &map, const BUCKET_TOPN &iterable, BUCKETS_TOPN &buckets) {
 
-        const float minLog = bb_sort::getLog(iterable.findMin());
-        const float maxLog = bb_sort::getLog(iterable.findMax());
-
-        const std::tuple<float, float> params = bb_sort::GetLinearTransformParams(minLog, maxLog, 0, count - 1);
-
-        const float a = std::get<0>(params);
-        const float b = std::get<1>(params);
-
-        for (auto & item : iterable) {
-            // ApplyLinearTransform
-            int index = ((a * bb_sort::getLog(item) + b));
-            index = std::min(count - 1, index);
-            buckets[index].push(item);
-        }
+        map.forEachIndex(iterable.begin(), iterable.size(), [&](const T & item, int index) { buckets[index].push(item); });
     }
 
     template<typename T>
@@ -56,11 +43,11 @@ namespace bb_sort_top_n_lazy {
         }
     }
 
-    template<typename T>
+    template<typename T, typename Map>
     int case1(STACK_TOPN &st,
               std::vector<T> &output,
               int index,
-              MAP_TOPN &countMap) {
+              Map &countMap) {
 
         const T b1 = *(st.top()).begin();
         const auto count = countMap[b1];
@@ -72,11 +59,11 @@ namespace bb_sort_top_n_lazy {
         return count;
     }
 
-    template<typename T>
+    template<typename T, typename Map>
     int case2(STACK_TOPN &st,
               std::vector<T> &output,
               int index,
-              MAP_TOPN &countMap) {
+              Map &countMap) {
 
         auto it = st.top().begin();
 
@@ -94,11 +81,11 @@ namespace bb_sort_top_n_lazy {
         return count1 + count2;
     }
 
-    template<typename T>
+    template<typename T, typename Map>
     int case3(STACK_TOPN &st,
               std::vector<T> &output,
               int index,
-              MAP_TOPN &countMap) {
+              Map &countMap) {
 
         //single comparison
         auto &top = st.top();
@@ -121,21 +108,63 @@ namespace bb_sort_top_n_lazy {
         return count1 + count2 + count3;
     }
 
-    template<typename T>
+    ///Bucket map can not split items of the bucket apart, they are sorted by comparisons.
+    template<typename T, typename Map>
+    int caseSorted(STACK_TOPN &st,
+                   std::vector<T> &output,
+                   int index,
+                   Map &countMap) {
+
+        const auto &top = st.top();
+
+        pool::vector<T> items;
+        items.reserve(top.size());
+
+        for (const auto &item : top) {
+
+            items.push_back(item);
+        }
+
+        std::sort(items.begin(), items.end());
+
+        int count = 0;
+
+        for (const auto &item : items) {
+
+            const auto itemCount = countMap[item];
+
+            fillStream<T>(item, output, index + count, itemCount);
+
+            count += itemCount;
+        }
+
+        st.pop();
+
+        return count;
+    }
+
+    template<typename T, typename Map>
     int caseN(STACK_TOPN &st,
               std::vector<T> &output,
               int index,
-              MAP_TOPN &countMap) {
+              Map &countMap) {
 
         const int count = (st.top().size() / 2) + 1;
 
+        const bb_sort::bucket_map<T> map(st.top().findMin(), st.top().findMax(), count);
+
+        if (!map.canSplit()) {
+
+            return caseSorted(st, output, index, countMap);
+        }
+
         BUCKETS_TOPN newBuckets(count);
 
-        getBuckets<T>(st.top(), newBuckets, count);
+        bb_sort_top_n_lazy::getBuckets<T>(map, st.top(), newBuckets);
 
         st.pop();
 
-        for (int i = newBuckets.size() - 1; i >= 0; --i) {
+        for (long int i = newBuckets.findPrevValue(newBuckets.size()); i >= 0; i = newBuckets.findPrevValue(i)) {
             if (newBuckets[i].size() > 0)
             {
                 st.emplace(std::move(newBuckets[i]));
@@ -152,8 +181,8 @@ namespace bb_sort_top_n_lazy {
     template<typename Func>
     Func *const func_array<Func>::switchCase[] = {case1, case2, case3, caseN};
 
-    template<typename T>
-    void bbSortToStream(STACK_TOPN &st, std::vector<T> &output, const long int count, MAP_TOPN& countMap) {
+    template<typename T, typename Map>
+    void bbSortToStream(STACK_TOPN &st, std::vector<T> &output, const long int count, Map& countMap) {
 
         int index = 0;
 
@@ -164,7 +193,7 @@ namespace bb_sort_top_n_lazy {
                     STACK_TOPN &,
                     std::vector<T> &,
                     int,
-                    MAP_TOPN &)>
+                    Map &)>
             ::switchCase[caseIndex];
 
             index += switchCaseFunc(st, output, index, countMap);
@@ -179,23 +208,13 @@ namespace bb_sort_top_n_lazy {
                             const T &maxSortEl,
                             int count) {
 
-        const float minLog = bb_sort::getLog(minSortEl);
-        const float maxLog = bb_sort::getLog(maxSortEl);
-
-        const std::tuple<float, float> params =  bb_sort::GetLinearTransformParams(minLog, maxLog, 0, count - 1);
-
-        const float a = std::get<0>(params);
-        const float b = std::get<1>(params);
+        const bb_sort::bucket_map<T> bucketMap(minSortEl, maxSortEl, count);
 
         //pushing distinct items only
-        for (auto & key : map) {
-            // ApplyLinearTransform
-            int index = ((a * bb_sort::getLog(key.first) + b));
-            index = std::min(count - 1, index);
-            buckets[index].push(key.first);
-        }
+        bucketMap.forEachIndex(map.begin(), map.end(), [](const auto & key) { return key.first; },
+                               [&](const auto & key, int index) { buckets[index].push(key.first); });
 
-        for (int i = buckets.size() - 1; i >= 0; --i) {
+        for (long int i = buckets.findPrevValue(buckets.size()); i >= 0; i = buckets.findPrevValue(i)) {
 
             if (buckets[i].size() > 0)
             {
@@ -206,6 +225,32 @@ namespace bb_sort_top_n_lazy {
     }
 
 
+    template<typename T>
+    void prepareTopBuckets(STACK_TOPN &st,
+                           BUCKETS_TOPN &buckets,
+                           const bb_sort::partitioned_count_map<T> &counts,
+                           const T &minSortEl,
+                           const T &maxSortEl,
+                           int count) {
+
+        const bb_sort::bucket_map<T> bucketMap(minSortEl, maxSortEl, count);
+
+        //distinct items of every partition go to the same buckets, partitions hold disjoint keys.
+        for (const auto & partition : counts.Partitions) {
+
+            bucketMap.forEachIndex(partition.begin(), partition.end(), [](const auto & key) { return key.first; },
+                                   [&](const auto & key, int index) { buckets[index].push(key.first); });
+        }
+
+        for (long int i = buckets.findPrevValue(buckets.size()); i >= 0; i = buckets.findPrevValue(i)) {
+
+            if (buckets[i].size() > 0)
+            {
+                st.emplace(std::move(buckets[i]));
+            }
+        }
+    }
+
     template<typename T>
     std::vector<T> getTopSortedLazy(std::vector<T> &array, long int count) {
 
@@ -249,5 +294,47 @@ namespace bb_sort_top_n_lazy {
 
         return result;
     }
+
+    ///Same as above, distinct items are counted by threadCount threads into partitioned map.
+    template<typename T>
+    std::vector<T> getTopSortedLazyParallel(std::vector<T> &array, long int count, unsigned int threadCount = std::thread::hardware_concurrency()) {
+
+        long int size = array.size();
+
+        if (threadCount <= 1 || size < bb_sort::parallelTaskMin) {
+
+            return getTopSortedLazy(array, count);
+        }
+
+        count = std::min(size, count);
+        std::vector<T> result(count);
+
+        const auto [minEl, maxEl] = bb_sort::getMinMax(array);
+
+        bb_sort::partitioned_count_map<T> countMap(threadCount);
+
+        countMap.count(array, threadCount);
+
+        const int bucketCount = std::min(countMap.size(), 128l);
+
+        BUCKETS_TOPN buckets(bucketCount);
+
+        STACK_TOPN topBucketsStack;
+
+        prepareTopBuckets(topBucketsStack, buckets, countMap, minEl, maxEl, bucketCount);
+
+        bbSortToStream<T>(topBucketsStack, result, count, countMap);
+
+        return result;
+    }
+
+    ///Sequential top N with scratch arrays allocated from resource instead of global array pool.
+    template<typename T>
+    std::vector<T> getTopSortedLazy(std::vector<T> &array, long int count, std::pmr::memory_resource * resource) {
+
+        pool::memory_scope scope(resource);
+
+        return getTopSortedLazy(array, count);
+    }
 }
 #endif
@@ -0,0 +1,177 @@
+#ifndef BBSORT_SOLUTION_BB_SORT_HEAVY_HITTERS_H
+#define BBSORT_SOLUTION_BB_SORT_HEAVY_HITTERS_H
+
+#include "poolable_vector.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace bb_sort_heavy {
+
+    ///Smaller inputs are not sampled, their duplicates are cheap to catch by all duplicates case.
+    const long int sampleFrom = 1 << 14;
+
+    const int sampleSize = 1024;
+
+    ///Value is heavy hitter when it takes at least 1/shareMin of sample.
+    const int shareMin = 16;
+
+    const int hittersMax = 4;
+
+    ///Values making up large share of input, ordered ascending.
+    template<typename T>
+    struct heavy_hitters {
+
+        int Count = 0;
+
+        T Values[hittersMax];
+        long int Counts[hittersMax] = {};
+    };
+
+    ///Finds heavy hitters in strided sample of values. Counts are sample counts.
+    template<typename T>
+    heavy_hitters<T> getHeavyHitters(const T * values, long int size) {
+
+        heavy_hitters<T> hitters;
+
+        if (size < sampleFrom) {
+
+            return hitters;
+        }
+
+        pool::vector<T> sample;
+        sample.reserve(sampleSize);
+
+        for (int i = 0; i < sampleSize; ++i) {
+
+            sample.push_back(values[(i * size) / sampleSize]);
+        }
+
+        std::sort(sample.begin(), sample.end());
+
+        //at most shareMin runs are long enough, only the longest hittersMax ones are kept.
+        std::pair<long int, T> runs[shareMin];
+        int runCount = 0;
+
+        for (int i = 0; i < sampleSize;) {
+
+            int j = i + 1;
+
+            while (j < sampleSize && sample[j] == sample[i]) {
+
+                ++j;
+            }
+
+            if (j - i >= sampleSize / shareMin) {
+
+                runs[runCount++] = {j - i, sample[i]};
+            }
+
+            i = j;
+        }
+
+        std::sort(runs, runs + runCount, [](const auto & a, const auto & b) { return a.first > b.first; });
+
+        hitters.Count = std::min(runCount, hittersMax);
+
+        std::sort(runs, runs + hitters.Count, [](const auto & a, const auto & b) { return a.second < b.second; });
+
+        for (int i = 0; i < hitters.Count; ++i) {
+
+            hitters.Counts[i] = runs[i].first;
+            hitters.Values[i] = runs[i].second;
+        }
+
+        return hitters;
+    }
+
+    ///Top level buckets split by heavy hitters. Segment s holds items between heavy hitters s - 1 and s,
+    ///its stack keeps buckets in reverse order. Heavy hitters are only counted and written back by one fill per value.
+    template<typename T, typename Stack>
+    class segments {
+
+    public:
+
+        heavy_hitters<T> Hitters;
+
+        //lazy stacks are not movable, so segments own them by pointer.
+        std::vector<std::unique_ptr<Stack>> Stacks;
+
+        int Sizes[hittersMax + 1] = {};
+
+        bool empty() const { return Hitters.Count == 0; }
+
+        ///Samples values for heavy hitters and prepares segment stacks of count buckets if there are any.
+        ///Stacks of previous detection are reset and reused.
+        bool detect(const T * values, long int size, int count) {
+
+            Hitters = getHeavyHitters(values, size);
+
+            std::fill(Hitters.Counts, Hitters.Counts + Hitters.Count, 0);
+            std::fill(Sizes, Sizes + hittersMax + 1, 0);
+
+            Stacks.reserve(Hitters.Count + 1);
+
+            for (int i = 0; i < Hitters.Count + 1 && !empty(); ++i) {
+
+                if (i < Stacks.size()) {
+
+                    Stacks[i]->reset(count);
+                    continue;
+                }
+
+                Stacks.emplace_back(std::make_unique<Stack>(count));
+            }
+
+            return !empty();
+        }
+
+        template<typename Map>
+        void scatter(const T * values, long int size, const Map & map, int count) {
+
+            map.forEachIndex(values, size, [&](const T & item, int index) {
+
+                int segment = 0;
+
+                for (int i = 0; i < Hitters.Count; ++i) {
+
+                    if (item == Hitters.Values[i]) {
+
+                        ++Hitters.Counts[i];
+                        return;
+                    }
+
+                    segment += Hitters.Values[i] < item;
+                }
+
+                ++Sizes[segment];
+
+                (*Stacks[segment])[count - index - 1].push(item);
+            });
+        }
+
+        ///Sorts every segment by sortSegment(stack, index) and fills heavy hitter runs between them.
+        template<typename Func>
+        void write(std::vector<T> & output, Func sortSegment) {
+
+            int index = 0;
+
+            for (int s = 0; s <= Hitters.Count; ++s) {
+
+                sortSegment(*Stacks[s], index);
+
+                index += Sizes[s];
+
+                if (s < Hitters.Count) {
+
+                    std::fill_n(output.begin() + index, Hitters.Counts[s], Hitters.Values[s]);
+
+                    index += Hitters.Counts[s];
+                }
+            }
+        }
+    };
+}
+
+#endif //BBSORT_SOLUTION_BB_SORT_HEAVY_HITTERS_H
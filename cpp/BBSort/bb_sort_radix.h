@@ -0,0 +1,113 @@
+#ifndef BBSORT_SOLUTION_BB_SORT_RADIX_H
+#define BBSORT_SOLUTION_BB_SORT_RADIX_H
+
+#include "bucket_map.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace bb_sort_radix {
+
+    const int digitBits = 8;
+    const int digitCount = 1 << digitBits;
+
+    ///Buckets spanning up to this many key digits are radix sorted instead of being split further.
+    const int lowSpreadDigits = 2;
+
+    ///Smaller buckets do not pay back digit histograms.
+    const int lowSpreadMin = 256;
+
+    template<typename T>
+    constexpr bool hasKey = std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+    ///Unsigned key ordered the same way as items.
+    template<typename T>
+    inline uint64_t getKey(const T & x) {
+
+        if constexpr (std::is_integral_v<T>) {
+
+            return (uint64_t) x - (uint64_t) std::numeric_limits<T>::min();
+        } else {
+
+            return bb_sort::getOrderedBits(x);
+        }
+    }
+
+    ///Keys of [min, max] range share all bits above the highest bit differing between min and max keys,
+    ///so only digits below it are sorted by.
+    template<typename T>
+    inline int getDigits(const T & min, const T & max) {
+
+        return (std::bit_width(getKey(min) ^ getKey(max)) + digitBits - 1) / digitBits;
+    }
+
+    template<typename T>
+    inline bool isLowSpread(const T & min, const T & max, int size) {
+
+        if constexpr (hasKey<T>) {
+
+            return size >= lowSpreadMin && getDigits(min, max) <= lowSpreadDigits;
+        } else {
+
+            return false;
+        }
+    }
+
+    ///LSD radix sort of items of [min, max] range, every pass moves items to the other buffer.
+    ///Returns items or scratch, whichever holds sorted items. Types without key are sorted by std::sort in place.
+    template<typename T>
+    T * sort(T * items, T * scratch, int size, const T & min, const T & max) {
+
+        if constexpr (!hasKey<T>) {
+
+            std::sort(items, items + size);
+            return items;
+        } else {
+
+            const int digits = getDigits(min, max);
+
+            int counts[digitCount];
+
+            for (int digit = 0; digit < digits; ++digit) {
+
+                const int shift = digit * digitBits;
+
+                std::fill(counts, counts + digitCount, 0);
+
+                for (int i = 0; i < size; ++i) {
+
+                    ++counts[(getKey(items[i]) >> shift) & (digitCount - 1)];
+                }
+
+                //digit is the same for every item.
+                if (counts[(getKey(items[0]) >> shift) & (digitCount - 1)] == size) {
+
+                    continue;
+                }
+
+                int offset = 0;
+
+                for (int i = 0; i < digitCount; ++i) {
+
+                    const int count = counts[i];
+                    counts[i] = offset;
+                    offset += count;
+                }
+
+                for (int i = 0; i < size; ++i) {
+
+                    scratch[counts[(getKey(items[i]) >> shift) & (digitCount - 1)]++] = items[i];
+                }
+
+                std::swap(items, scratch);
+            }
+
+            return items;
+        }
+    }
+}
+
+#endif //BBSORT_SOLUTION_BB_SORT_RADIX_H
@@ -0,0 +1,58 @@
+#ifndef BBSORT_SOLUTION_BB_SORT_SORTER_H
+#define BBSORT_SOLUTION_BB_SORT_SORTER_H
+
+#include "bb_sort.h"
+#include "bb_sort_dictless_min_max_vect.h"
+#include "memory_scope.h"
+
+#include <vector>
+
+namespace bb_sort {
+
+    ///Context for repeated sorts of similar batches. Bucket arrays are rented from own array resource,
+    ///stacks, count map and output buffer keep their capacity, so sorts stop allocating after warm up.
+    ///Sorter is not thread safe, every thread needs its own.
+    template<typename T>
+    class sorter {
+
+    public:
+
+        ///Sorts array by min max vector engine.
+        void sort(std::vector<T> & array, top_mapping mapping = top_mapping::Keys) {
+
+            pool::memory_scope scope(&resource);
+
+            bb_sort_dictless_min_max_vect::sort(array, stack, heavy, mapping);
+        }
+
+        ///Count smallest items of array sorted by dict engine. Result is owned by sorter and valid until the next call.
+        const std::vector<T> & getTopSorted(std::vector<T> & array, long int count) {
+
+            pool::memory_scope scope(&resource);
+
+            bb_sort::getTopSorted(array, count, output, top);
+
+            return output;
+        }
+
+        ///Resource scratch arrays come from, its limits and trim control memory kept between sorts.
+        pool::array_resource & getResource() {
+
+            return resource;
+        }
+
+    private:
+
+        //declared first, so containers give their arrays back before it is destroyed.
+        pool::array_resource resource;
+
+        minmax::bucket_stack<T> stack;
+        bb_sort_heavy::segments<T, minmax::bucket_stack<T>> heavy;
+
+        top_scratch<T> top{&resource};
+
+        std::vector<T> output;
+    };
+}
+
+#endif //BBSORT_SOLUTION_BB_SORT_SORTER_H
@@ -0,0 +1,484 @@
+#ifndef BBSORT_SOLUTION_BUCKET_MAP_H
+#define BBSORT_SOLUTION_BUCKET_MAP_H
+
+#include "bucket_map_simd.h"
+
+#include <tuple>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+namespace bb_sort {
+
+    inline float fastLog2(const float val) {
+        union { float val; int32_t x; } u = {val};
+        const float lg2 = (float) (((u.x >> 23) & 255) - 128);
+        u.x &= ~(255 << 23);
+        u.x += 127 << 23;
+        return lg2 + ((-0.3358287811f) * u.val + 2.0f) * u.val - 0.65871759316667f;
+    }
+
+    ///Values with abs < 2 are halved to keep the transform monotonic: fastLog2(2) is a bit greater than 1.
+    inline float getLog(float x) {
+
+        const float abs = std::abs(x);
+        if (abs < 2) {
+            return x * 0.5f;
+        }
+        const float lg = fastLog2(abs);
+        return x < 0 ? -lg : lg;
+    }
+
+    inline std::tuple<float, float> GetLinearTransformParams(const float x1,
+                                                             const float x2,
+                                                             const float y1,
+                                                             const float y2) {
+
+        const float dx = x1 - x2;
+
+        if (dx != 0.0) [[likely]] {
+            const float a = (y1 - y2) / dx;
+            const float b = y1 - (a * x1);
+
+            return std::make_tuple(a, b);
+        }
+
+        return std::make_tuple(0.0, 0.0);
+    }
+
+    ///Batch helpers shared by bucket maps, Map provides getIndexes(values, size, indexes).
+    template<typename Map, typename T>
+    class bucket_map_batches {
+
+    public:
+
+        ///Calls func(item, index) for every item of a contiguous block, indexes are computed by batches.
+        template<typename Func>
+        void forEachIndex(const T * values, int size, Func func) const {
+
+            int indexes[bb_sort_simd::blockSize];
+
+            for (int i = 0; i < size; i += bb_sort_simd::blockSize) {
+
+                const int length = std::min(bb_sort_simd::blockSize, size - i);
+
+                static_cast<const Map *>(this)->getIndexes(values + i, length, indexes);
+
+                for (int j = 0; j < length; ++j) {
+
+                    func(values[i + j], indexes[j]);
+                }
+            }
+        }
+
+        ///Same as above for items are not stored as T array, value(item) gives a key to map.
+        template<typename I, typename Value, typename Func>
+        void forEachIndex(I begin, I end, Value value, Func func) const {
+
+            T values[bb_sort_simd::blockSize];
+            int indexes[bb_sort_simd::blockSize];
+
+            while (begin != end) {
+
+                I blockBegin = begin;
+                int length = 0;
+
+                for (; begin != end && length < bb_sort_simd::blockSize; ++begin) {
+
+                    values[length++] = value(*begin);
+                }
+
+                static_cast<const Map *>(this)->getIndexes(values, length, indexes);
+
+                for (int j = 0; j < length; ++j, ++blockBegin) {
+
+                    func(*blockBegin, indexes[j]);
+                }
+            }
+        }
+    };
+
+    ///Maps items of [min, max] range to [0, count - 1] bucket indexes by linear transform of items log.
+    template<typename T>
+    class log_bucket_map : public bucket_map_batches<log_bucket_map<T>, T> {
+
+    public:
+
+        float MinLog;
+        float MaxLog;
+
+        float A;
+        float B;
+
+        int Count;
+
+        log_bucket_map(const T & min, const T & max, int count)
+                : MinLog(getLog(min)), MaxLog(getLog(max)), Count(count) {
+
+            const std::tuple<float, float> params = GetLinearTransformParams(MinLog, MaxLog, 0, count - 1);
+
+            A = std::get<0>(params);
+            B = std::get<1>(params);
+        }
+
+        ///Items too close in log scale are left for comparison sort.
+        bool canSplit() const {  return MaxLog - MinLog >= 0.1; }
+
+        int getIndex(const T & value) const {
+
+            // ApplyLinearTransform
+            int index = ((A * getLog(value) + B));
+            return std::max(0, std::min(Count - 1, index));
+        }
+
+        void getIndexes(const T * values, int size, int * indexes) const {
+
+            if (bb_sort_simd::getLogIndexes(values, size, A, B, Count, indexes)) {
+
+                return;
+            }
+
+            for (int i = 0; i < size; ++i) {
+
+                indexes[i] = getIndex(values[i]);
+            }
+        }
+    };
+
+    ///Scales order preserving keys of [min, max] range to [0, count - 1] by integer ops only. The range is shifted
+    ///to 32 bits, the rounded up multiplier sends max to the last bucket, so two distinct keys never share a bucket.
+    struct key_scale {
+
+        uint64_t MinKey;
+        uint64_t MaxKey;
+
+        int Shift = 0;
+        uint64_t Mul = 0;
+
+        key_scale(uint64_t minKey, uint64_t maxKey, int count)
+                : MinKey(minKey), MaxKey(maxKey) {
+
+            const uint64_t range = MaxKey - MinKey;
+
+            if (range == 0) {
+
+                return;
+            }
+
+            Shift = std::max(0, (int) std::bit_width(range) - 32);
+
+            const uint64_t scaled = range >> Shift;
+
+            Mul = (((uint64_t) (count - 1) << 32) + scaled - 1) / scaled;
+        }
+
+        ///Key is expected to be in [min, max] range.
+        int getIndex(uint64_t key) const {
+
+            return (int) ((((key - MinKey) >> Shift) * Mul) >> 32);
+        }
+    };
+
+    template<typename T>
+    inline uint64_t getAbs(const T & x) {
+
+        return x < 0 ? 0 - (uint64_t) x : (uint64_t) x;
+    }
+
+    ///Order preserving log scale key of integer: bit length of abs value goes first, then bits below the leading one.
+    template<typename T>
+    inline int64_t getLogKey(const T & x) {
+
+        const uint64_t abs = getAbs(x);
+
+        if (abs == 0) {
+
+            return 0;
+        }
+
+        const int zeros = std::countl_zero(abs);
+
+        //two shifts drop the leading one without shifting by 64.
+        const uint64_t fraction = (abs << zeros) << 1;
+        const int64_t key = ((int64_t) (64 - zeros) << 56) | (int64_t) (fraction >> 8);
+
+        return x < 0 ? -key : key;
+    }
+
+    ///Mapping is picked per bucket by its Min and Max: ranges crossing zero use signed log of items,
+    ///ranges within one octave are mapped linearly, others use log of item distance to the bound closest to zero.
+    enum class mapping { Log, Linear, OffsetLog };
+
+    ///Parameters of vector kernels computing the same keys and indexes as bucket maps do.
+    template<typename T>
+    inline bb_sort_simd::key_params<T> getKeyParams(const T & min, const T & max, const T & floor, mapping mode, const key_scale & scale) {
+
+        bb_sort_simd::key_kind kind = bb_sort_simd::key_kind::Linear;
+
+        if (mode == mapping::Log) {
+
+            kind = bb_sort_simd::key_kind::Log;
+        } else if (mode == mapping::OffsetLog) {
+
+            kind = min >= 0 ? bb_sort_simd::key_kind::OffsetLog : bb_sort_simd::key_kind::MirroredOffsetLog;
+        }
+
+        return {kind, min >= 0 ? min : max, floor, scale.MinKey, scale.Shift, scale.Mul};
+    }
+
+    ///Integer items are mapped by integer ops only.
+    template<typename T>
+    class integer_bucket_map : public bucket_map_batches<integer_bucket_map<T>, T> {
+
+    public:
+
+        T Min;
+        T Max;
+
+        mapping Mode;
+
+        key_scale Scale;
+
+        integer_bucket_map(const T & min, const T & max, int count)
+                : Min(min), Max(max), Mode(getMapping(min, max)), Scale(getKey(min), getKey(max), count) {
+        }
+
+        bool canSplit() const {  return Scale.MinKey != Scale.MaxKey; }
+
+        int getIndex(const T & value) const {  return Scale.getIndex(getKey(value)); }
+
+        void getIndexes(const T * values, int size, int * indexes) const {
+
+            if (bb_sort_simd::getKeyIndexes(values, size, getKeyParams(Min, Max, T(), Mode, Scale), indexes)) {
+
+                return;
+            }
+
+            switch (Mode) {
+
+                case mapping::Linear:
+
+                    fillIndexes(values, size, indexes, [](const T & value) { return (uint64_t) value; });
+                    return;
+
+                case mapping::Log:
+
+                    fillIndexes(values, size, indexes, [](const T & value) { return (uint64_t) getLogKey(value); });
+                    return;
+
+                case mapping::OffsetLog:
+
+                    if (Min >= 0) {
+
+                        fillIndexes(values, size, indexes, [this](const T & value) { return (uint64_t) getLogKey((uint64_t) value - (uint64_t) Min); });
+                    } else {
+
+                        fillIndexes(values, size, indexes, [this](const T & value) { return (uint64_t) -getLogKey((uint64_t) Max - (uint64_t) value); });
+                    }
+                    return;
+            }
+        }
+
+    private:
+
+        static mapping getMapping(const T & min, const T & max) {
+
+            if (min < 0 && max > 0) {
+
+                return mapping::Log;
+            }
+
+            return std::bit_width(getAbs(min)) == std::bit_width(getAbs(max)) ? mapping::Linear : mapping::OffsetLog;
+        }
+
+        uint64_t getKey(const T & value) const {
+
+            switch (Mode) {
+
+                case mapping::Linear:
+
+                    return (uint64_t) value;
+
+                case mapping::Log:
+
+                    return (uint64_t) getLogKey(value);
+
+                default:
+
+                    return Min >= 0 ? (uint64_t) getLogKey((uint64_t) value - (uint64_t) Min)
+                                    : (uint64_t) -getLogKey((uint64_t) Max - (uint64_t) value);
+            }
+        }
+
+        template<typename Key>
+        void fillIndexes(const T * values, int size, int * indexes, Key key) const {
+
+            for (int i = 0; i < size; ++i) {
+
+                indexes[i] = Scale.getIndex(key(values[i]));
+            }
+        }
+    };
+
+    ///IEEE-754 bits as unsigned integer ordered the same way as values: exponent is the log, mantissa is the fine position.
+    inline uint64_t getOrderedBits(double x) {
+
+        const uint64_t bits = std::bit_cast<uint64_t>(x);
+        return (bits >> 63) ? ~bits : bits | (1ull << 63);
+    }
+
+    inline uint64_t getOrderedBits(float x) {
+
+        const uint32_t bits = std::bit_cast<uint32_t>(x);
+        return (bits >> 31) ? ~bits : bits | (1u << 31);
+    }
+
+    ///Floating point items are mapped by ordered bits at full precision of the type. Log mappings ignore magnitudes
+    ///below the largest one scaled by 2^-logOctaves, otherwise most of buckets would be spent for tiny exponents.
+    template<typename T>
+    class ordered_bits_bucket_map : public bucket_map_batches<ordered_bits_bucket_map<T>, T> {
+
+    public:
+
+        static const int logOctaves = 32;
+
+        T Min;
+        T Max;
+
+        mapping Mode;
+
+        T Floor;
+
+        key_scale Scale;
+
+        ordered_bits_bucket_map(const T & min, const T & max, int count)
+                : Min(min), Max(max), Mode(getMapping(min, max)), Floor(getFloor(min, max, Mode)), Scale(getKey(min), getKey(max), count) {
+        }
+
+        bool canSplit() const {  return Scale.MinKey != Scale.MaxKey; }
+
+        int getIndex(const T & value) const {  return Scale.getIndex(getKey(value)); }
+
+        void getIndexes(const T * values, int size, int * indexes) const {
+
+            if (bb_sort_simd::getKeyIndexes(values, size, getKeyParams(Min, Max, Floor, Mode, Scale), indexes)) {
+
+                return;
+            }
+
+            switch (Mode) {
+
+                case mapping::Linear:
+
+                    fillIndexes(values, size, indexes, [](const T & value) { return getOrderedBits(value); });
+                    return;
+
+                case mapping::Log:
+
+                    fillIndexes(values, size, indexes, [this](const T & value) { return getSignedKey(value); });
+                    return;
+
+                case mapping::OffsetLog:
+
+                    if (Min >= 0) {
+
+                        fillIndexes(values, size, indexes, [this](const T & value) { return getOrderedBits(std::max(value - Min, Floor)); });
+                    } else {
+
+                        fillIndexes(values, size, indexes, [this](const T & value) { return ~getOrderedBits(std::max(Max - value, Floor)); });
+                    }
+                    return;
+            }
+        }
+
+    private:
+
+        static mapping getMapping(const T & min, const T & max) {
+
+            //infinite bounds or span would make floor infinite, plain ordered bits keep every item apart.
+            if (!std::isfinite(min) || !std::isfinite(max) || !std::isfinite(max - min)) {
+
+                return mapping::Linear;
+            }
+
+            if (min < 0 && max > 0) {
+
+                return mapping::Log;
+            }
+
+            return (min != 0 && std::ilogb(min) == std::ilogb(max)) ? mapping::Linear : mapping::OffsetLog;
+        }
+
+        ///Floor is used by log mappings only, their bounds and span are finite.
+        static T getFloor(const T & min, const T & max, mapping mode) {
+
+            if (mode == mapping::Linear) {
+
+                return 0;
+            }
+
+            const T magnitude = mode == mapping::Log ? std::max(-min, max) : max - min;
+
+            return std::ldexp(magnitude, -logOctaves);
+        }
+
+        uint64_t getSignedKey(const T & value) const {
+
+            return value >= 0 ? getOrderedBits(std::max(value, Floor)) : getOrderedBits(std::min(value, -Floor));
+        }
+
+        uint64_t getKey(const T & value) const {
+
+            switch (Mode) {
+
+                case mapping::Linear:
+
+                    return getOrderedBits(value);
+
+                case mapping::Log:
+
+                    return getSignedKey(value);
+
+                default:
+
+                    return Min >= 0 ? getOrderedBits(std::max(value - Min, Floor))
+                                    : ~getOrderedBits(std::max(Max - value, Floor));
+            }
+        }
+
+        template<typename Key>
+        void fillIndexes(const T * values, int size, int * indexes, Key key) const {
+
+            for (int i = 0; i < size; ++i) {
+
+                indexes[i] = Scale.getIndex(key(values[i]));
+            }
+        }
+    };
+
+    template<typename T, typename Enable = void>
+    struct bucket_map_traits {
+
+        using type = log_bucket_map<T>;
+    };
+
+    template<typename T>
+    struct bucket_map_traits<T, std::enable_if_t<std::is_integral_v<T>>> {
+
+        using type = integer_bucket_map<T>;
+    };
+
+    template<typename T>
+    struct bucket_map_traits<T, std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>>> {
+
+        using type = ordered_bits_bucket_map<T>;
+    };
+
+    ///Bucket map used by sort engines for items of type T.
+    template<typename T>
+    using bucket_map = typename bucket_map_traits<T>::type;
+}
+
+#endif //BBSORT_SOLUTION_BUCKET_MAP_H
@@ -0,0 +1,664 @@
+#ifndef BBSORT_SOLUTION_BUCKET_MAP_SIMD_H
+#define BBSORT_SOLUTION_BUCKET_MAP_SIMD_H
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BB_SORT_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace bb_sort_simd {
+
+    ///Keys of bb_sort::integer_bucket_map and bb_sort::ordered_bits_bucket_map: MirroredOffsetLog is OffsetLog of ranges below zero.
+    enum class key_kind { Linear, Log, OffsetLog, MirroredOffsetLog };
+
+    ///Key computation and bb_sort::key_scale parameters, Bound is Min for OffsetLog and Max for MirroredOffsetLog.
+    template<typename T>
+    struct key_params {
+
+        key_kind Kind;
+
+        T Bound;
+        T Floor;
+
+        uint64_t MinKey;
+        int Shift;
+        uint64_t Mul;
+    };
+
+    ///Types having key kernels: 4 and 8 byte integers, float and double.
+    template<typename T>
+    constexpr bool hasKeyKernels = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8);
+
+    ///Every kernel repeats bb_sort::getLog and the bucket linear transform operation by operation,
+    ///FMA contraction is disabled so indexes are the same as computed by scalar code.
+#ifdef BB_SORT_SIMD_X86
+
+#define BB_SORT_SIMD_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+
+    BB_SORT_SIMD_TARGET("sse2")
+    inline __m128i getLogIndexes4(__m128 x, __m128 a, __m128 b, __m128i maxIndex) {
+
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+        const __m128 abs = _mm_andnot_ps(signMask, x);
+
+        const __m128i bits = _mm_castps_si128(abs);
+        const __m128 lg2 = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(255)), _mm_set1_epi32(128)));
+        const __m128 m = _mm_castsi128_ps(_mm_add_epi32(_mm_and_si128(bits, _mm_set1_epi32(~(255 << 23))), _mm_set1_epi32(127 << 23)));
+
+        __m128 lg = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.3358287811f), m), _mm_set1_ps(2.0f)), m), lg2);
+        lg = _mm_sub_ps(lg, _mm_set1_ps(0.65871759316667f));
+        lg = _mm_xor_ps(lg, _mm_and_ps(signMask, x));
+
+        const __m128 small = _mm_cmplt_ps(abs, _mm_set1_ps(2.0f));
+        const __m128 log = _mm_or_ps(_mm_and_ps(small, _mm_mul_ps(x, _mm_set1_ps(0.5f))), _mm_andnot_ps(small, lg));
+
+        __m128i index = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, log), b));
+
+        const __m128i over = _mm_cmpgt_epi32(index, maxIndex);
+        index = _mm_or_si128(_mm_and_si128(over, maxIndex), _mm_andnot_si128(over, index));
+
+        return _mm_andnot_si128(_mm_cmplt_epi32(index, _mm_setzero_si128()), index);
+    }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256i getLogIndexes8(__m256 x, __m256 a, __m256 b, __m256i maxIndex) {
+
+        const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+        const __m256 abs = _mm256_andnot_ps(signMask, x);
+
+        const __m256i bits = _mm256_castps_si256(abs);
+        const __m256 lg2 = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(255)), _mm256_set1_epi32(128)));
+        const __m256 m = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_and_si256(bits, _mm256_set1_epi32(~(255 << 23))), _mm256_set1_epi32(127 << 23)));
+
+        __m256 lg = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-0.3358287811f), m), _mm256_set1_ps(2.0f)), m), lg2);
+        lg = _mm256_sub_ps(lg, _mm256_set1_ps(0.65871759316667f));
+        lg = _mm256_xor_ps(lg, _mm256_and_ps(signMask, x));
+
+        const __m256 small = _mm256_cmp_ps(abs, _mm256_set1_ps(2.0f), _CMP_LT_OQ);
+        const __m256 log = _mm256_blendv_ps(lg, _mm256_mul_ps(x, _mm256_set1_ps(0.5f)), small);
+
+        const __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(a, log), b));
+
+        return _mm256_max_epi32(_mm256_min_epi32(index, maxIndex), _mm256_setzero_si256());
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f")
+    inline __m512i getLogIndexes16(__m512 x, __m512 a, __m512 b, __m512i maxIndex) {
+
+        const __m512i signMask = _mm512_set1_epi32(0x80000000);
+        const __m512i xBits = _mm512_castps_si512(x);
+
+        const __m512i bits = _mm512_andnot_si512(signMask, xBits);
+        const __m512 abs = _mm512_castsi512_ps(bits);
+        const __m512 lg2 = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_and_si512(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(255)), _mm512_set1_epi32(128)));
+        const __m512 m = _mm512_castsi512_ps(_mm512_add_epi32(_mm512_and_si512(bits, _mm512_set1_epi32(~(255 << 23))), _mm512_set1_epi32(127 << 23)));
+
+        __m512 lg = _mm512_add_ps(_mm512_mul_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(-0.3358287811f), m), _mm512_set1_ps(2.0f)), m), lg2);
+        lg = _mm512_sub_ps(lg, _mm512_set1_ps(0.65871759316667f));
+        lg = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(lg), _mm512_and_si512(signMask, xBits)));
+
+        const __mmask16 small = _mm512_cmp_ps_mask(abs, _mm512_set1_ps(2.0f), _CMP_LT_OQ);
+        const __m512 log = _mm512_mask_blend_ps(small, lg, _mm512_mul_ps(x, _mm512_set1_ps(0.5f)));
+
+        const __m512i index = _mm512_cvttps_epi32(_mm512_add_ps(_mm512_mul_ps(a, log), b));
+
+        return _mm512_max_epi32(_mm512_min_epi32(index, maxIndex), _mm512_setzero_si512());
+    }
+
+    BB_SORT_SIMD_TARGET("sse2")
+    inline void getLogIndexesSse2(const float * values, int size, float a, float b, int count, int * indexes) {
+
+        const __m128 va = _mm_set1_ps(a);
+        const __m128 vb = _mm_set1_ps(b);
+        const __m128i maxIndex = _mm_set1_epi32(count - 1);
+
+        int i = 0;
+
+        for (; i + 4 <= size; i += 4) {
+
+            _mm_storeu_si128((__m128i *) (indexes + i), getLogIndexes4(_mm_loadu_ps(values + i), va, vb, maxIndex));
+        }
+
+        if (i < size) {
+
+            float tail[4] = {};
+            int tailIndexes[4];
+
+            std::memcpy(tail, values + i, (size - i) * sizeof(float));
+            _mm_storeu_si128((__m128i *) tailIndexes, getLogIndexes4(_mm_loadu_ps(tail), va, vb, maxIndex));
+            std::memcpy(indexes + i, tailIndexes, (size - i) * sizeof(int));
+        }
+    }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline void getLogIndexesAvx2(const float * values, int size, float a, float b, int count, int * indexes) {
+
+        const __m256 va = _mm256_set1_ps(a);
+        const __m256 vb = _mm256_set1_ps(b);
+        const __m256i maxIndex = _mm256_set1_epi32(count - 1);
+
+        int i = 0;
+
+        for (; i + 8 <= size; i += 8) {
+
+            _mm256_storeu_si256((__m256i *) (indexes + i), getLogIndexes8(_mm256_loadu_ps(values + i), va, vb, maxIndex));
+        }
+
+        if (i < size) {
+
+            float tail[8] = {};
+            int tailIndexes[8];
+
+            std::memcpy(tail, values + i, (size - i) * sizeof(float));
+            _mm256_storeu_si256((__m256i *) tailIndexes, getLogIndexes8(_mm256_loadu_ps(tail), va, vb, maxIndex));
+            std::memcpy(indexes + i, tailIndexes, (size - i) * sizeof(int));
+        }
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f")
+    inline void getLogIndexesAvx512(const float * values, int size, float a, float b, int count, int * indexes) {
+
+        const __m512 va = _mm512_set1_ps(a);
+        const __m512 vb = _mm512_set1_ps(b);
+        const __m512i maxIndex = _mm512_set1_epi32(count - 1);
+
+        int i = 0;
+
+        for (; i + 16 <= size; i += 16) {
+
+            _mm512_storeu_si512(indexes + i, getLogIndexes16(_mm512_loadu_ps(values + i), va, vb, maxIndex));
+        }
+
+        if (i < size) {
+
+            const __mmask16 tail = (__mmask16) ((1u << (size - i)) - 1);
+
+            _mm512_mask_storeu_epi32(indexes + i, tail, getLogIndexes16(_mm512_maskz_loadu_ps(tail, values + i), va, vb, maxIndex));
+        }
+    }
+
+    ///Key kernels repeat scalar key computation of bucket maps lane by lane, then scale keys as bb_sort::key_scale does.
+    ///Scaled key is below 2^32 and multiplier is below 2^40, so product is split to 32 bit halves of the multiplier.
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256i getLogKeys4(__m256i abs) {
+
+        //bit width of 32 bit half holding the leading one is read from exponent of its exact double.
+        const __m256i hi = _mm256_srli_epi64(abs, 32);
+        const __m256i hasHi = _mm256_cmpgt_epi64(hi, _mm256_setzero_si256());
+        const __m256i half = _mm256_blendv_epi8(_mm256_and_si256(abs, _mm256_set1_epi64x(0xffffffff)), hi, hasHi);
+
+        const __m256i magic = _mm256_set1_epi64x(0x4330000000000000);
+        const __m256d exact = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(half, magic)), _mm256_castsi256_pd(magic));
+        const __m256i exponent = _mm256_srli_epi64(_mm256_castpd_si256(exact), 52);
+
+        __m256i width = _mm256_sub_epi64(exponent, _mm256_set1_epi64x(1022));
+        width = _mm256_and_si256(width, _mm256_cmpgt_epi64(half, _mm256_setzero_si256()));
+        width = _mm256_add_epi64(width, _mm256_and_si256(hasHi, _mm256_set1_epi64x(32)));
+
+        const __m256i zeros = _mm256_sub_epi64(_mm256_set1_epi64x(64), width);
+        const __m256i fraction = _mm256_slli_epi64(_mm256_sllv_epi64(abs, zeros), 1);
+
+        return _mm256_or_si256(_mm256_slli_epi64(width, 56), _mm256_srli_epi64(fraction, 8));
+    }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256i getSignedLogKeys4(__m256i x) {
+
+        const __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+        const __m256i key = getLogKeys4(_mm256_sub_epi64(_mm256_xor_si256(x, negative), negative));
+
+        return _mm256_sub_epi64(_mm256_xor_si256(key, negative), negative);
+    }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256i getOrderedBits4(__m128 x) {
+
+        const __m128i bits = _mm_castps_si128(x);
+        const __m128i flip = _mm_or_si128(_mm_srai_epi32(bits, 31), _mm_set1_epi32(0x80000000));
+
+        return _mm256_cvtepu32_epi64(_mm_xor_si128(bits, flip));
+    }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256i getOrderedBits4(__m256d x) {
+
+        const __m256i bits = _mm256_castpd_si256(x);
+        const __m256i flip = _mm256_or_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(), bits), _mm256_set1_epi64x(0x8000000000000000));
+
+        return _mm256_xor_si256(bits, flip);
+    }
+
+    ///Operand order of max and min instructions repeats std::max and std::min for equal items.
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m128 maxOf(__m128 a, __m128 b) {  return _mm_max_ps(b, a); }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m128 minOf(__m128 a, __m128 b) {  return _mm_min_ps(b, a); }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256d maxOf(__m256d a, __m256d b) {  return _mm256_max_pd(b, a); }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256d minOf(__m256d a, __m256d b) {  return _mm256_min_pd(b, a); }
+
+    template<typename T>
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m256i getKeys4(const T * values, const key_params<T> & params) {
+
+        if constexpr (std::is_same_v<T, float>) {
+
+            const __m128 x = _mm_loadu_ps(values);
+            const __m128 bound = _mm_set1_ps(params.Bound);
+            const __m128 floor = _mm_set1_ps(params.Floor);
+
+            switch (params.Kind) {
+
+                case key_kind::Linear:
+
+                    return getOrderedBits4(x);
+
+                case key_kind::Log:
+
+                    return getOrderedBits4(_mm_blendv_ps(minOf(x, _mm_set1_ps(-params.Floor)), maxOf(x, floor), _mm_cmpge_ps(x, _mm_setzero_ps())));
+
+                case key_kind::OffsetLog:
+
+                    return getOrderedBits4(maxOf(_mm_sub_ps(x, bound), floor));
+
+                default:
+
+                    return _mm256_xor_si256(getOrderedBits4(maxOf(_mm_sub_ps(bound, x), floor)), _mm256_set1_epi64x(-1));
+            }
+        } else if constexpr (std::is_same_v<T, double>) {
+
+            const __m256d x = _mm256_loadu_pd(values);
+            const __m256d bound = _mm256_set1_pd(params.Bound);
+            const __m256d floor = _mm256_set1_pd(params.Floor);
+
+            switch (params.Kind) {
+
+                case key_kind::Linear:
+
+                    return getOrderedBits4(x);
+
+                case key_kind::Log:
+
+                    return getOrderedBits4(_mm256_blendv_pd(minOf(x, _mm256_set1_pd(-params.Floor)), maxOf(x, floor), _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_GE_OQ)));
+
+                case key_kind::OffsetLog:
+
+                    return getOrderedBits4(maxOf(_mm256_sub_pd(x, bound), floor));
+
+                default:
+
+                    return _mm256_xor_si256(getOrderedBits4(maxOf(_mm256_sub_pd(bound, x), floor)), _mm256_set1_epi64x(-1));
+            }
+        } else {
+
+            __m256i x;
+
+            if constexpr (sizeof(T) == 4) {
+
+                const __m128i items = _mm_loadu_si128((const __m128i *) values);
+                x = std::is_signed_v<T> ? _mm256_cvtepi32_epi64(items) : _mm256_cvtepu32_epi64(items);
+            } else {
+
+                x = _mm256_loadu_si256((const __m256i *) values);
+            }
+
+            //bound is extended the same way as items, offsets wrap around as unsigned.
+            const __m256i bound = _mm256_set1_epi64x((int64_t) params.Bound);
+
+            switch (params.Kind) {
+
+                case key_kind::Linear:
+
+                    return x;
+
+                case key_kind::Log:
+
+                    return std::is_signed_v<T> ? getSignedLogKeys4(x) : getLogKeys4(x);
+
+                case key_kind::OffsetLog:
+
+                    return getLogKeys4(_mm256_sub_epi64(x, bound));
+
+                default:
+
+                    return _mm256_sub_epi64(_mm256_setzero_si256(), getLogKeys4(_mm256_sub_epi64(bound, x)));
+            }
+        }
+    }
+
+    BB_SORT_SIMD_TARGET("avx2")
+    inline __m128i scaleKeys4(__m256i keys, __m256i minKey, __m128i shift, __m256i mulLo, __m256i mulHi) {
+
+        const __m256i scaled = _mm256_srl_epi64(_mm256_sub_epi64(keys, minKey), shift);
+        const __m256i index = _mm256_add_epi64(_mm256_srli_epi64(_mm256_mul_epu32(scaled, mulLo), 32), _mm256_mul_epu32(scaled, mulHi));
+
+        return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(index, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+    }
+
+    template<typename T>
+    BB_SORT_SIMD_TARGET("avx2")
+    inline void getKeyIndexesAvx2(const T * values, int size, const key_params<T> & params, int * indexes) {
+
+        const __m256i minKey = _mm256_set1_epi64x(params.MinKey);
+        const __m128i shift = _mm_cvtsi32_si128(params.Shift);
+        const __m256i mulLo = _mm256_set1_epi64x(params.Mul & 0xffffffff);
+        const __m256i mulHi = _mm256_set1_epi64x(params.Mul >> 32);
+
+        int i = 0;
+
+        for (; i + 4 <= size; i += 4) {
+
+            _mm_storeu_si128((__m128i *) (indexes + i), scaleKeys4(getKeys4(values + i, params), minKey, shift, mulLo, mulHi));
+        }
+
+        if (i < size) {
+
+            T tail[4] = {};
+            int tailIndexes[4];
+
+            std::memcpy(tail, values + i, (size - i) * sizeof(T));
+            _mm_storeu_si128((__m128i *) tailIndexes, scaleKeys4(getKeys4(tail, params), minKey, shift, mulLo, mulHi));
+            std::memcpy(indexes + i, tailIndexes, (size - i) * sizeof(int));
+        }
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m512i getLogKeys8(__m512i abs) {
+
+        const __m512i zeros = _mm512_lzcnt_epi64(abs);
+        const __m512i fraction = _mm512_slli_epi64(_mm512_sllv_epi64(abs, zeros), 1);
+
+        return _mm512_or_si512(_mm512_slli_epi64(_mm512_sub_epi64(_mm512_set1_epi64(64), zeros), 56), _mm512_srli_epi64(fraction, 8));
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m512i getSignedLogKeys8(__m512i x) {
+
+        const __mmask8 negative = _mm512_cmplt_epi64_mask(x, _mm512_setzero_si512());
+        const __m512i key = getLogKeys8(_mm512_abs_epi64(x));
+
+        return _mm512_mask_sub_epi64(key, negative, _mm512_setzero_si512(), key);
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m512i getOrderedBits8(__m256 x) {
+
+        const __m256i bits = _mm256_castps_si256(x);
+        const __m256i flip = _mm256_or_si256(_mm256_srai_epi32(bits, 31), _mm256_set1_epi32(0x80000000));
+
+        return _mm512_cvtepu32_epi64(_mm256_xor_si256(bits, flip));
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m512i getOrderedBits8(__m512d x) {
+
+        const __m512i bits = _mm512_castpd_si512(x);
+        const __m512i flip = _mm512_or_si512(_mm512_srai_epi64(bits, 63), _mm512_set1_epi64(0x8000000000000000));
+
+        return _mm512_xor_si512(bits, flip);
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m256 maxOf(__m256 a, __m256 b) {  return _mm256_max_ps(b, a); }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m256 minOf(__m256 a, __m256 b) {  return _mm256_min_ps(b, a); }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m512d maxOf(__m512d a, __m512d b) {  return _mm512_max_pd(b, a); }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m512d minOf(__m512d a, __m512d b) {  return _mm512_min_pd(b, a); }
+
+    template<typename T>
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m512i getKeys8(const T * values, const key_params<T> & params) {
+
+        if constexpr (std::is_same_v<T, float>) {
+
+            const __m256 x = _mm256_loadu_ps(values);
+            const __m256 bound = _mm256_set1_ps(params.Bound);
+            const __m256 floor = _mm256_set1_ps(params.Floor);
+
+            switch (params.Kind) {
+
+                case key_kind::Linear:
+
+                    return getOrderedBits8(x);
+
+                case key_kind::Log:
+
+                    return getOrderedBits8(_mm256_blendv_ps(minOf(x, _mm256_set1_ps(-params.Floor)), maxOf(x, floor), _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GE_OQ)));
+
+                case key_kind::OffsetLog:
+
+                    return getOrderedBits8(maxOf(_mm256_sub_ps(x, bound), floor));
+
+                default:
+
+                    return _mm512_xor_si512(getOrderedBits8(maxOf(_mm256_sub_ps(bound, x), floor)), _mm512_set1_epi64(-1));
+            }
+        } else if constexpr (std::is_same_v<T, double>) {
+
+            const __m512d x = _mm512_loadu_pd(values);
+            const __m512d bound = _mm512_set1_pd(params.Bound);
+            const __m512d floor = _mm512_set1_pd(params.Floor);
+
+            switch (params.Kind) {
+
+                case key_kind::Linear:
+
+                    return getOrderedBits8(x);
+
+                case key_kind::Log:
+
+                    return getOrderedBits8(_mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_GE_OQ), minOf(x, _mm512_set1_pd(-params.Floor)), maxOf(x, floor)));
+
+                case key_kind::OffsetLog:
+
+                    return getOrderedBits8(maxOf(_mm512_sub_pd(x, bound), floor));
+
+                default:
+
+                    return _mm512_xor_si512(getOrderedBits8(maxOf(_mm512_sub_pd(bound, x), floor)), _mm512_set1_epi64(-1));
+            }
+        } else {
+
+            __m512i x;
+
+            if constexpr (sizeof(T) == 4) {
+
+                const __m256i items = _mm256_loadu_si256((const __m256i *) values);
+                x = std::is_signed_v<T> ? _mm512_cvtepi32_epi64(items) : _mm512_cvtepu32_epi64(items);
+            } else {
+
+                x = _mm512_loadu_si512(values);
+            }
+
+            const __m512i bound = _mm512_set1_epi64((int64_t) params.Bound);
+
+            switch (params.Kind) {
+
+                case key_kind::Linear:
+
+                    return x;
+
+                case key_kind::Log:
+
+                    return std::is_signed_v<T> ? getSignedLogKeys8(x) : getLogKeys8(x);
+
+                case key_kind::OffsetLog:
+
+                    return getLogKeys8(_mm512_sub_epi64(x, bound));
+
+                default:
+
+                    return _mm512_sub_epi64(_mm512_setzero_si512(), getLogKeys8(_mm512_sub_epi64(bound, x)));
+            }
+        }
+    }
+
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline __m256i scaleKeys8(__m512i keys, __m512i minKey, __m128i shift, __m512i mulLo, __m512i mulHi) {
+
+        const __m512i scaled = _mm512_srl_epi64(_mm512_sub_epi64(keys, minKey), shift);
+        const __m512i index = _mm512_add_epi64(_mm512_srli_epi64(_mm512_mul_epu32(scaled, mulLo), 32), _mm512_mul_epu32(scaled, mulHi));
+
+        return _mm512_cvtepi64_epi32(index);
+    }
+
+    template<typename T>
+    BB_SORT_SIMD_TARGET("avx512f,avx512cd")
+    inline void getKeyIndexesAvx512(const T * values, int size, const key_params<T> & params, int * indexes) {
+
+        const __m512i minKey = _mm512_set1_epi64(params.MinKey);
+        const __m128i shift = _mm_cvtsi32_si128(params.Shift);
+        const __m512i mulLo = _mm512_set1_epi64(params.Mul & 0xffffffff);
+        const __m512i mulHi = _mm512_set1_epi64(params.Mul >> 32);
+
+        int i = 0;
+
+        for (; i + 8 <= size; i += 8) {
+
+            _mm256_storeu_si256((__m256i *) (indexes + i), scaleKeys8(getKeys8(values + i, params), minKey, shift, mulLo, mulHi));
+        }
+
+        if (i < size) {
+
+            T tail[8] = {};
+            int tailIndexes[8];
+
+            std::memcpy(tail, values + i, (size - i) * sizeof(T));
+            _mm256_storeu_si256((__m256i *) tailIndexes, scaleKeys8(getKeys8(tail, params), minKey, shift, mulLo, mulHi));
+            std::memcpy(indexes + i, tailIndexes, (size - i) * sizeof(int));
+        }
+    }
+
+#undef BB_SORT_SIMD_TARGET
+
+    using log_indexes_kernel = void (*)(const float *, int, float, float, int, int *);
+
+    inline log_indexes_kernel selectLogIndexesKernel() {
+
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f")) {
+
+            return getLogIndexesAvx512;
+        }
+
+        if (__builtin_cpu_supports("avx2")) {
+
+            return getLogIndexesAvx2;
+        }
+
+        return getLogIndexesSse2;
+    }
+
+    ///Kernel is chosen once by the instruction sets of the running CPU.
+    inline bool getLogIndexes(const float * values, int size, float a, float b, int count, int * indexes) {
+
+        static const log_indexes_kernel kernel = selectLogIndexesKernel();
+
+        kernel(values, size, a, b, count, indexes);
+
+        return true;
+    }
+
+    enum class key_kernels { None, Avx2, Avx512 };
+
+    inline key_kernels selectKeyKernels() {
+
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd")) {
+
+            return key_kernels::Avx512;
+        }
+
+        return __builtin_cpu_supports("avx2") ? key_kernels::Avx2 : key_kernels::None;
+    }
+
+    ///Computes clamped bucket indexes by keys of bucket maps, returns false if there is no kernel for the type or CPU.
+    template<typename T>
+    inline bool getKeyIndexes(const T * values, int size, const key_params<T> & params, int * indexes) {
+
+        static const key_kernels kernels = selectKeyKernels();
+
+        if constexpr (hasKeyKernels<T>) {
+
+            switch (kernels) {
+
+                case key_kernels::Avx512:
+
+                    getKeyIndexesAvx512(values, size, params, indexes);
+                    return true;
+
+                case key_kernels::Avx2:
+
+                    getKeyIndexesAvx2(values, size, params, indexes);
+                    return true;
+
+                default:
+
+                    return false;
+            }
+        }
+
+        return false;
+    }
+
+#else
+
+    inline bool getLogIndexes(const float * values, int size, float a, float b, int count, int * indexes) {
+
+        return false;
+    }
+
+    template<typename T>
+    inline bool getKeyIndexes(const T * values, int size, const key_params<T> & params, int * indexes) {
+
+        return false;
+    }
+
+#endif
+
+    ///Items of a block are converted to float the same way getLog(float) parameter does.
+    const int blockSize = 256;
+
+    ///Computes clamped bucket indexes of a block of items, returns false if there is no vector kernel for the platform.
+    template<typename T>
+    inline bool getLogIndexes(const T * values, int size, float a, float b, int count, int * indexes) {
+
+        float block[blockSize];
+
+        for (int i = 0; i < size; i += blockSize) {
+
+            const int length = std::min(blockSize, size - i);
+
+            for (int j = 0; j < length; ++j) {
+
+                block[j] = values[i + j];
+            }
+
+            if (!getLogIndexes(block, length, a, b, count, indexes + i)) {
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+#endif //BBSORT_SOLUTION_BUCKET_MAP_SIMD_H
@@ -0,0 +1,360 @@
+#ifndef BBSORT_SOLUTION_BUCKET_STACK_H
+#define BBSORT_SOLUTION_BUCKET_STACK_H
+
+#include "poolable_vector.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace minmax {
+
+    ///Stack of min max mid buckets kept as struct of arrays: slot s has Counts[s] items, Mins[s], Maxs[s] and Mids[s],
+    ///items of slots larger than inlineMax are in Items[s] array of Capacities[s] size. Empty slot is just zero count,
+    ///so pushing and dropping buckets costs nothing and metadata of a level takes a few cache lines per array.
+    ///Item arrays are rented from the resource of the thread creating the stack.
+    template<typename T>
+    class bucket_stack {
+
+    public:
+
+        ///Buckets of up to inlineMax items never rent storage, leaf cases read Mins, Mids and Maxs.
+        static constexpr unsigned int inlineMax = 3;
+
+        pool::vector<unsigned int> Counts;
+        pool::vector<T> Mins;
+        pool::vector<T> Maxs;
+
+        ///Has valid and reliable value for slots of 3 items only.
+        pool::vector<T> Mids;
+
+        pool::vector<T *> Items;
+        pool::vector<unsigned int> Capacities;
+
+        ///Slot handle, so stack can be filled the same way as a table of buckets.
+        class slot_ref {
+
+            bucket_stack * stack;
+            long int slot;
+
+        public:
+
+            slot_ref(bucket_stack * stack, long int slot) : stack(stack), slot(slot) {
+            }
+
+            void push(const T & value) { stack->push(slot, value); }
+
+            unsigned int size() const { return stack->Counts.array[slot]; }
+        };
+
+        explicit bucket_stack(long int count = 0) : resource(pool::scopeResource) {
+
+            pushEmpty(count);
+        }
+
+        bucket_stack(const bucket_stack &) = delete;
+        bucket_stack & operator=(const bucket_stack &) = delete;
+
+        ~bucket_stack() {
+
+            for (long int slot = 0; slot < length; ++slot) {
+
+                releaseItems(slot);
+            }
+        }
+
+        ///Drops all slots and pushes count empty ones, slot arrays are kept. Empty stack rents from current scope resource.
+        void reset(long int count) {
+
+            for (long int slot = 0; slot < length; ++slot) {
+
+                releaseItems(slot);
+            }
+
+            length = 0;
+
+            resource = pool::scopeResource;
+
+            pushEmpty(count);
+        }
+
+        bool empty() const { return length == 0; }
+
+        long int size() const { return length; }
+
+        long int back() const { return length - 1; }
+
+        unsigned int count(long int slot) const { return Counts.array[slot]; }
+
+        slot_ref operator[](long int slot) { return slot_ref(this, slot); }
+
+        ///Pushes count empty slots, only their counts are written.
+        void pushEmpty(long int count) {
+
+            if (count <= 0) {
+
+                return;
+            }
+
+            reserveSlots(length + count);
+
+            std::memset(Counts.array + length, 0, sizeof(unsigned int) * count);
+
+            length += count;
+        }
+
+        void push(long int slot, const T & value) {
+
+            unsigned int & count = Counts.array[slot];
+
+            T & min = Mins.array[slot];
+            T & max = Maxs.array[slot];
+
+            if (count == 0) {
+
+                min = value;
+                max = value;
+
+                count = 1;
+                return;
+            }
+
+            if (count == inlineMax) {
+
+                spill(slot);
+            }
+
+            if (count == 2) {
+
+                if (value < min) {
+
+                    Mids.array[slot] = min;
+                    min = value;
+                } else if (value > max) {
+
+                    Mids.array[slot] = max;
+                    max = value;
+                } else {
+
+                    Mids.array[slot] = value;
+                }
+            } else {
+
+                min = std::min(value, min);
+                max = std::max(value, max);
+            }
+
+            if (count >= inlineMax) {
+
+                if (count == Capacities.array[slot]) {
+
+                    grow(slot, count * 2);
+                }
+
+                Items.array[slot][count] = value;
+            }
+
+            ++count;
+        }
+
+        ///Drops back slot and gives back its item array.
+        void pop_back() {
+
+            releaseItems(back());
+
+            --length;
+        }
+
+        ///Drops empty slots at the back.
+        void trimBack() {
+
+            while (length > 0 && Counts.array[length - 1] == 0) {
+
+                --length;
+            }
+        }
+
+        ///Drops back slot and hands its item array over to caller, who returns it by releaseArray.
+        T * detachBack(unsigned int & count, unsigned int & capacity) {
+
+            const long int slot = back();
+
+            count = Counts.array[slot];
+            capacity = Capacities.array[slot];
+
+            --length;
+
+            return Items.array[slot];
+        }
+
+        void releaseArray(T * items, unsigned int capacity) {
+
+            pool::returnScopeArray<T>(items, capacity, resource);
+        }
+
+        ///Moves slot of this stack to the back of other stack, slot is left empty.
+        void moveSlot(long int slot, bucket_stack & other) {
+
+            other.pushEmpty(1);
+
+            other.adopt(other.back(), *this, slot);
+        }
+
+        ///Moves items of other stack slot to the end of slot, other slot is left empty.
+        void append(long int slot, bucket_stack & other, long int otherSlot) {
+
+            const unsigned int otherCount = other.Counts.array[otherSlot];
+
+            if (otherCount == 0) {
+
+                return;
+            }
+
+            if (Counts.array[slot] == 0) {
+
+                adopt(slot, other, otherSlot);
+                return;
+            }
+
+            if (Counts.array[slot] > inlineMax && otherCount > inlineMax) {
+
+                const unsigned int count = Counts.array[slot] + otherCount;
+
+                if (count > Capacities.array[slot]) {
+
+                    grow(slot, count);
+                }
+
+                std::copy(other.Items.array[otherSlot], other.Items.array[otherSlot] + otherCount, Items.array[slot] + Counts.array[slot]);
+
+                Mins.array[slot] = std::min(Mins.array[slot], other.Mins.array[otherSlot]);
+                Maxs.array[slot] = std::max(Maxs.array[slot], other.Maxs.array[otherSlot]);
+
+                Counts.array[slot] = count;
+
+                other.releaseItems(otherSlot);
+                return;
+            }
+
+            other.forEachItem(otherSlot, [&](const T & item) { push(slot, item); });
+
+            other.releaseItems(otherSlot);
+        }
+
+        template<typename Func>
+        void forEachItem(long int slot, Func func) const {
+
+            const unsigned int count = Counts.array[slot];
+
+            if (count > inlineMax) {
+
+                std::for_each(Items.array[slot], Items.array[slot] + count, func);
+                return;
+            }
+
+            if (count > 0) {
+
+                func(Mins.array[slot]);
+            }
+
+            if (count == 3) {
+
+                func(Mids.array[slot]);
+            }
+
+            if (count >= 2) {
+
+                func(Maxs.array[slot]);
+            }
+        }
+
+    private:
+
+        long int length = 0;
+        long int capacity = 0;
+
+        std::pmr::memory_resource * resource;
+
+        void reserveSlots(long int slots) {
+
+            if (slots <= capacity) {
+
+                return;
+            }
+
+            capacity = std::max({slots, capacity * 2, 16l});
+
+            //vectors copy only length items when growing.
+            Counts.length = Mins.length = Maxs.length = Mids.length = Items.length = Capacities.length = length;
+
+            Counts.reserve(capacity);
+            Mins.reserve(capacity);
+            Maxs.reserve(capacity);
+            Mids.reserve(capacity);
+            Items.reserve(capacity);
+            Capacities.reserve(capacity);
+        }
+
+        ///Moves inline items to item array when slot grows past inlineMax.
+        void spill(long int slot) {
+
+            std::size_t size = 16;
+
+            T * items = pool::rentResourceArray<T>(size, resource);
+
+            items[0] = Mins.array[slot];
+            items[1] = Mids.array[slot];
+            items[2] = Maxs.array[slot];
+
+            Items.array[slot] = items;
+            Capacities.array[slot] = size;
+        }
+
+        void grow(long int slot, std::size_t size) {
+
+            T * items = pool::rentResourceArray<T>(size, resource);
+
+            std::copy(Items.array[slot], Items.array[slot] + Counts.array[slot], items);
+
+            releaseArray(Items.array[slot], Capacities.array[slot]);
+
+            Items.array[slot] = items;
+            Capacities.array[slot] = size;
+        }
+
+        void releaseItems(long int slot) {
+
+            if (Counts.array[slot] > inlineMax) {
+
+                releaseArray(Items.array[slot], Capacities.array[slot]);
+            }
+
+            Counts.array[slot] = 0;
+        }
+
+        ///Takes over other slot, item array is copied when stacks rent from different resources.
+        void adopt(long int slot, bucket_stack & other, long int otherSlot) {
+
+            const unsigned int count = other.Counts.array[otherSlot];
+
+            if (count > inlineMax && other.resource != resource) {
+
+                Counts.array[slot] = 0;
+
+                other.forEachItem(otherSlot, [&](const T & item) { push(slot, item); });
+                other.releaseItems(otherSlot);
+                return;
+            }
+
+            Counts.array[slot] = count;
+            Mins.array[slot] = other.Mins.array[otherSlot];
+            Maxs.array[slot] = other.Maxs.array[otherSlot];
+            Mids.array[slot] = other.Mids.array[otherSlot];
+            Items.array[slot] = other.Items.array[otherSlot];
+            Capacities.array[slot] = other.Capacities.array[otherSlot];
+
+            other.Counts.array[otherSlot] = 0;
+        }
+    };
+}
+
+#endif //BBSORT_SOLUTION_BUCKET_STACK_H
@@ -0,0 +1,118 @@
+#ifndef BBSORT_SOLUTION_CDF_BUCKET_MAP_H
+#define BBSORT_SOLUTION_CDF_BUCKET_MAP_H
+
+#include "bucket_map.h"
+#include "bb_sort_radix.h"
+#include "poolable_vector.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace bb_sort {
+
+    ///Mapping of the top level scatter: keys scaled between min and max, or CDF model fitted to input sample.
+    enum class top_mapping { Keys, Cdf };
+
+    ///Maps items to buckets by piecewise linear CDF model fitted to a sample of input: knots are sample quantiles,
+    ///so each segment between them gets the same share of buckets. Keys are bb_sort_radix keys,
+    ///first knot is min and last one is max, so min goes to the first bucket and max to the last one.
+    template<typename T>
+    class cdf_bucket_map : public bucket_map_batches<cdf_bucket_map<T>, T> {
+
+    public:
+
+        static constexpr int sampleMax = 4096;
+        static constexpr int segmentsMax = 64;
+
+        int Count;
+        int Segments;
+
+        uint64_t Knots[segmentsMax + 1];
+
+        cdf_bucket_map(const T * values, long int size, const T & min, const T & max, int count)
+                : Count(count) {
+
+            const int sampleSize = (int) std::min<long int>(size, sampleMax);
+
+            pool::vector<uint64_t> sample;
+            sample.reserve(sampleSize);
+
+            for (int i = 0; i < sampleSize; ++i) {
+
+                sample.push_back(bb_sort_radix::getKey(values[(i * size) / sampleSize]));
+            }
+
+            std::sort(sample.begin(), sample.end());
+
+            Segments = std::max(1, std::min(segmentsMax, sampleSize - 1));
+
+            for (int i = 0; i <= Segments; ++i) {
+
+                Knots[i] = sample[((long int) i * (sampleSize - 1)) / Segments];
+            }
+
+            Knots[0] = bb_sort_radix::getKey(min);
+            Knots[Segments] = bb_sort_radix::getKey(max);
+        }
+
+        bool canSplit() const {  return Knots[0] != Knots[Segments]; }
+
+        int getIndex(const T & value) const {
+
+            const uint64_t key = bb_sort_radix::getKey(value);
+
+            const int segment = std::upper_bound(Knots + 1, Knots + Segments, key) - (Knots + 1);
+
+            const uint64_t width = Knots[segment + 1] - Knots[segment];
+            const double fraction = width == 0 ? 0.0 : (double) (key - Knots[segment]) / (double) width;
+
+            const int index = (int) (((segment + fraction) / Segments) * Count);
+
+            return std::min(Count - 1, index);
+        }
+
+        void getIndexes(const T * values, int size, int * indexes) const {
+
+            for (int i = 0; i < size; ++i) {
+
+                indexes[i] = getIndex(values[i]);
+            }
+        }
+    };
+
+    ///Summary of bucket sizes produced by a bucket map, ideal mapping has every bucket of Mean size.
+    struct bucket_balance {
+
+        int Buckets = 0;
+        int NonEmpty = 0;
+
+        long int Largest = 0;
+        double Mean = 0;
+    };
+
+    template<typename T, typename Map>
+    bucket_balance getBucketBalance(const Map & map, const T * values, long int size, int count) {
+
+        pool::vector<long int> sizes;
+        sizes.reserve(count);
+
+        std::fill(sizes.array, sizes.array + count, 0);
+
+        map.forEachIndex(values, size, [&](const T & item, int index) { ++sizes.array[index]; });
+
+        bucket_balance balance;
+
+        balance.Buckets = count;
+        balance.Mean = (double) size / count;
+
+        for (int i = 0; i < count; ++i) {
+
+            balance.NonEmpty += sizes.array[i] > 0;
+            balance.Largest = std::max(balance.Largest, sizes.array[i]);
+        }
+
+        return balance;
+    }
+}
+
+#endif //BBSORT_SOLUTION_CDF_BUCKET_MAP_H
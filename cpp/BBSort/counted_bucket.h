@@ -0,0 +1,77 @@
+#ifndef BBSORT_SOLUTION_COUNTED_BUCKET_H
+#define BBSORT_SOLUTION_COUNTED_BUCKET_H
+
+#include "poolable_vector.h"
+
+namespace minmax {
+
+    ///Bucket of distinct items with their copy counts: Counts[i] belongs to Items[i]. Counts are filled
+    ///on the first repeating item, bucket without them has single copies only, so unique items move alone.
+    ///Min and max are kept on push.
+    template<typename T>
+    class counted_bucket {
+
+    public:
+
+        pool::vector<T> Items;
+        pool::vector<int> Counts;
+
+        void push(const T & item, int count) {
+
+            if (Items.length == 0) {
+
+                min = item;
+                max = item;
+            } else if (item < min) {
+
+                min = item;
+            } else if (item > max) {
+
+                max = item;
+            }
+
+            if (count > 1 || Counts.length > 0) {
+
+                if (Counts.length < Items.length) {
+
+                    Counts.reserve(Items.length + 1);
+
+                    for (size_t i = 0; i < Items.length; ++i) {
+
+                        Counts.push_back(1);
+                    }
+                }
+
+                Counts.push_back(count);
+            }
+
+            Items.push_back(item);
+
+            total += count;
+        }
+
+        unsigned int size() const { return Items.length; }
+
+        ///Number of items with their copies.
+        long int getTotal() const { return total; }
+
+        int getCount(unsigned int index) const { return Counts.length > 0 ? Counts.array[index] : 1; }
+
+        const T & findMin() const { return min; }
+
+        const T & findMax() const { return max; }
+
+        const T * begin() const { return Items.array; }
+
+        const T * end() const { return Items.array + Items.length; }
+
+    private:
+
+        T min{};
+        T max{};
+
+        long int total = 0;
+    };
+}
+
+#endif //BBSORT_SOLUTION_COUNTED_BUCKET_H
@@ -5,10 +5,69 @@
 
 namespace pool {
 
+    ///Every thread rents from its own cache pool, which is not synchronized.
+    ///Arrays may be returned from any thread, they are kept by the cache of the returning thread.
+    ///Caches exchange arrays with the shared pool in batches, so arrays returned by other threads
+    ///and arrays of finished threads get back to threads renting them.
     template<class T>
-    class global_array_pool {   public: static array_pool <T> GLOBAL_POOL;    };
+    class global_array_pool {
+
+    public:
+
+        static shared_array_pool<T> SHARED_POOL;
+
+        static thread_local array_pool <T> GLOBAL_POOL;
+
+        ///Sets idle byte caps of the shared pool and of the calling thread cache.
+        static void setLimits(const pool_limits & shared, const pool_limits & cache = {}) {
+
+            SHARED_POOL.setLimits(shared);
+            GLOBAL_POOL.setLimits(cache);
+        }
+
+        ///Releases idle arrays of the calling thread cache and of the shared pool, caches of other threads are kept.
+        static void trim() {
+
+            GLOBAL_POOL.trim();
+            SHARED_POOL.trim();
+        }
+
+        ///Rents and returns of all threads, counted only when BB_SORT_POOL_STATS is defined.
+        static pool_stats_snapshot getStats() {
+
+            return SHARED_POOL.Stats.snapshot();
+        }
+
+        static void resetStats() {
+
+            SHARED_POOL.Stats.reset();
+        }
+
+        ///Gives an array per size to the shared pool, so the first rent of any thread takes it from there.
+        ///Arrays above shared pool limits and sizes above maxArrayLength are not kept.
+        template<typename Sizes>
+        static void warm(const Sizes & sizes) {
+
+            for (std::size_t size : sizes) {
+
+                if (size > array_pool<T>::maxArrayLength) {
+
+                    continue;
+                }
+
+                const int sizeClass = array_pool<T>::selectBucketIndex(size);
+
+                T * array = static_cast<T *>(allocateArray(shared_array_pool<T>::getArrayBytes(sizeClass)));
+
+                SHARED_POOL.give(sizeClass, &array, 1);
+            }
+        }
+    };
+
+    template<class T>
+    constinit shared_array_pool<T> global_array_pool<T>::SHARED_POOL;
 
     template<class T>
-    array_pool <T> global_array_pool<T>::GLOBAL_POOL;
+    thread_local array_pool <T> global_array_pool<T>::GLOBAL_POOL(&global_array_pool<T>::SHARED_POOL);
 }
 #endif //BBSORT_SOLUTION_GLOBAL_POOL_H
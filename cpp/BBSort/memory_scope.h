@@ -0,0 +1,148 @@
+#ifndef BBSORT_SOLUTION_MEMORY_SCOPE_H
+#define BBSORT_SOLUTION_MEMORY_SCOPE_H
+
+#include <memory_resource>
+
+#include "global_array_pool.h"
+
+namespace pool {
+
+    ///Resource pool vectors of the calling thread allocate from, global array pool when null.
+    inline thread_local std::pmr::memory_resource * scopeResource = nullptr;
+
+    ///Resource of the calling thread scope for std::pmr containers, default resource outside of scopes.
+    inline std::pmr::memory_resource * getScopeResource() {
+
+        return scopeResource != nullptr ? scopeResource : std::pmr::get_default_resource();
+    }
+
+    ///Makes pool vectors created or grown on the calling thread allocate from resource until the scope ends.
+    ///Vectors remember the resource of their array, so they must not outlive it.
+    class memory_scope {
+
+        std::pmr::memory_resource * previous;
+
+    public:
+
+        explicit memory_scope(std::pmr::memory_resource * resource) : previous(scopeResource) {
+
+            scopeResource = resource;
+        }
+
+        ~memory_scope() {
+
+            scopeResource = previous;
+        }
+
+        memory_scope(const memory_scope &) = delete;
+        memory_scope & operator=(const memory_scope &) = delete;
+    };
+
+    ///Monotonic arena for scratch of one sort: arrays are bump allocated and released all at once when it is destroyed.
+    ///Returned buckets are not reused, so peak memory is the sum of all buckets rented by the sort.
+    class sort_arena : public std::pmr::monotonic_buffer_resource {
+
+    public:
+
+        explicit sort_arena(std::size_t initialBytes = 1 << 16) : std::pmr::monotonic_buffer_resource(initialBytes) {
+        }
+    };
+
+    ///Resource keeping released blocks in power of two size classes of own array pool, like global pool does for arrays,
+    ///so a long living owner stops allocating once its working set is pooled. It is not thread safe.
+    ///Blocks are aligned to std::max_align_t, larger alignment is not supported.
+    class array_resource : public std::pmr::memory_resource {
+
+        struct alignas(std::max_align_t) unit {
+
+            unsigned char bytes[alignof(std::max_align_t)];
+        };
+
+        array_pool<unit> arrays;
+
+        static std::size_t getUnits(std::size_t bytes) {
+
+            return (bytes + sizeof(unit) - 1) / sizeof(unit);
+        }
+
+    public:
+
+        ///Stats of own pool, they are collected only when BB_SORT_POOL_STATS is defined.
+        pool_stats & getStats() {
+
+            return arrays.getStats();
+        }
+
+        std::size_t getIdleBytes() const {
+
+            return arrays.getIdleBytes();
+        }
+
+        void setLimits(const pool_limits & value) {
+
+            arrays.setLimits(value);
+        }
+
+        ///Releases all idle blocks.
+        void trim() {
+
+            arrays.trim();
+        }
+
+    protected:
+
+        void * do_allocate(std::size_t bytes, std::size_t alignment) override {
+
+            std::size_t units = getUnits(bytes);
+
+            return arrays.rentArray(units);
+        }
+
+        void do_deallocate(void * block, std::size_t bytes, std::size_t alignment) override {
+
+            std::size_t units = getUnits(bytes);
+
+            arrays.returnArray(static_cast<unit *>(block), units);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override {
+
+            return this == &other;
+        }
+    };
+
+    ///Rents array of at least capacity items from resource, from global pool when it is null.
+    template<typename T>
+    T * rentResourceArray(std::size_t & capacity, std::pmr::memory_resource * resource) {
+
+        if (resource != nullptr) {
+
+            return static_cast<T *>(resource->allocate(sizeof(T) * capacity, alignof(T)));
+        }
+
+        return global_array_pool<T>::GLOBAL_POOL.rentArray(capacity);
+    }
+
+    ///Rents array of at least capacity items from scope resource or global pool, resource is set to the source.
+    template<typename T>
+    T * rentScopeArray(std::size_t & capacity, std::pmr::memory_resource *& resource) {
+
+        resource = scopeResource;
+
+        return rentResourceArray<T>(capacity, resource);
+    }
+
+    template<typename T>
+    void returnScopeArray(T * array, std::size_t capacity, std::pmr::memory_resource * resource) {
+
+        if (resource != nullptr) {
+
+            resource->deallocate(array, sizeof(T) * capacity, alignof(T));
+            return;
+        }
+
+        global_array_pool<T>::GLOBAL_POOL.returnArray(array, capacity);
+    }
+}
+
+#endif //BBSORT_SOLUTION_MEMORY_SCOPE_H
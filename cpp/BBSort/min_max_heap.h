@@ -442,7 +442,7 @@ namespace minmax
 
         bool allDuplicates(){
 
-            return heap_.array[1] == heap_.array[0];
+            return findMin() == findMax();
         }
 
         const std::tuple<unsigned int, unsigned int, unsigned int> getMaxMidMin() const
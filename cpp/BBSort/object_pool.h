@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <stdexcept>
 #include <iterator>
+#include <atomic>
+#include <mutex>
+#include <new>
 #include "ptr_vector.h"
 
 namespace pool
@@ -31,6 +34,11 @@ namespace pool
             return items.size() == 0;
         }
 
+        std::size_t size() const {
+
+            return items.size();
+        }
+
         pointer pop() {
 
             if (items.any()) {
@@ -50,6 +58,108 @@ namespace pool
             items.push_back(object);
         }
     };
+
+    ///Free list shared by threads. Pooled objects are linked through their own memory, so they have to be
+    ///at least pointer sized and not alive while pooled. Push is lock-free and links a whole batch by one swap.
+    ///Pops are serialized between themselves: node read by one pop can not be taken and pushed back by another
+    ///one meanwhile, so head swap is ABA safe without tagged pointers. Pushes never wait for pops.
+    template <typename T>
+    class concurrent_object_pool {
+
+        using value_type        = T;
+        using pointer           = T*;
+
+        struct node {
+
+            node * next;
+        };
+
+        std::atomic<node *> head = nullptr;
+        std::atomic<std::size_t> count = 0;
+
+        std::mutex popLock;
+
+    public:
+
+        constexpr concurrent_object_pool() {
+        }
+
+        bool empty() const {
+
+            return head.load(std::memory_order_relaxed) == nullptr;
+        }
+
+        std::size_t size() const {
+
+            return count.load(std::memory_order_relaxed);
+        }
+
+        void push(pointer object) {
+
+            push(&object, 1);
+        }
+
+        ///Pushes objects as a single chain.
+        void push(const pointer * objects, int size) {
+
+            if (size == 0) {
+
+                return;
+            }
+
+            node * first = new(objects[0]) node{nullptr};
+            node * last = first;
+
+            for (int i = 1; i < size; ++i) {
+
+                last = last->next = new(objects[i]) node{nullptr};
+            }
+
+            last->next = head.load(std::memory_order_relaxed);
+
+            while (!head.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+
+            count.fetch_add(size, std::memory_order_relaxed);
+        }
+
+        pointer pop() {
+
+            pointer object = nullptr;
+
+            pop(&object, 1);
+
+            return object;
+        }
+
+        ///Pops up to size objects by one swap of head, returns the number popped.
+        int pop(pointer * objects, int size) {
+
+            std::lock_guard<std::mutex> guard(popLock);
+
+            node * top = head.load(std::memory_order_acquire);
+
+            while (true) {
+
+                node * cut = top;
+                int popped = 0;
+
+                for (; popped < size && cut != nullptr; ++popped) {
+
+                    objects[popped] = reinterpret_cast<pointer>(cut);
+                    cut = cut->next;
+                }
+
+                //failed swap means objects were pushed on top, nodes below stay as they were.
+                if (head.compare_exchange_weak(top, cut, std::memory_order_acquire, std::memory_order_acquire)) {
+
+                    count.fetch_sub(popped, std::memory_order_relaxed);
+
+                    return popped;
+                }
+            }
+        }
+    };
 }
 
 #endif //BBSORT_SOLUTION_OBJECT_POOL_H
@@ -0,0 +1,89 @@
+#ifndef BBSORT_SOLUTION_PARTITIONED_COUNT_MAP_H
+#define BBSORT_SOLUTION_PARTITIONED_COUNT_MAP_H
+
+#include "fast_map.h"
+#include "work_stealing_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bb_sort {
+
+    ///Item counts split into maps by key hash, so every partition holds own keys and can be filled by own thread.
+    template<typename T>
+    class partitioned_count_map {
+
+    public:
+
+        using map_type = robin_hood::unordered_map<T, int>;
+
+        std::vector<map_type> Partitions;
+
+        explicit partitioned_count_map(unsigned int partitions) : Partitions(std::max(1u, partitions)) {
+        }
+
+        ///High bits of mixed hash, robin_hood map indexes its table by low ones.
+        unsigned int getPartition(const T & key) const {
+
+            const uint64_t mixed = (uint64_t) robin_hood::hash<T>{}(key) * UINT64_C(0xc4ceb9fe1a85ec53);
+
+            return (mixed >> 32) % Partitions.size();
+        }
+
+        int & operator[](const T & key) { return Partitions[getPartition(key)][key]; }
+
+        long int size() const {
+
+            long int size = 0;
+
+            for (const auto & partition : Partitions) {
+
+                size += partition.size();
+            }
+
+            return size;
+        }
+
+        ///Thread t counts own slice of array into own maps split by partition,
+        ///then thread p merges partition p of every thread. Partitions never get merged together.
+        void count(const std::vector<T> & array, unsigned int threadCount) {
+
+            const unsigned int partitions = Partitions.size();
+
+            std::vector<std::unique_ptr<map_type[]>> threadMaps(threadCount);
+
+            parallel::forEachSlice(array.size(), threadCount, [&](unsigned int t, long int begin, long int end) {
+
+                threadMaps[t] = std::make_unique<map_type[]>(partitions);
+
+                for (long int i = begin; i < end; ++i) {
+
+                    threadMaps[t][getPartition(array[i])][array[i]] += 1;
+                }
+            });
+
+            parallel::forEachSlice(partitions, std::min(threadCount, partitions), [&](unsigned int t, long int begin, long int end) {
+
+                for (long int p = begin; p < end; ++p) {
+
+                    map_type & partition = Partitions[p];
+
+                    partition = std::move(threadMaps[0][p]);
+
+                    for (unsigned int source = 1; source < threadCount; ++source) {
+
+                        for (const auto & item : threadMaps[source][p]) {
+
+                            partition[item.first] += item.second;
+                        }
+
+                        map_type release(std::move(threadMaps[source][p]));
+                    }
+                }
+            });
+        }
+    };
+}
+
+#endif //BBSORT_SOLUTION_PARTITIONED_COUNT_MAP_H
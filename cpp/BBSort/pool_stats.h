@@ -0,0 +1,267 @@
+#ifndef BBSORT_SOLUTION_POOL_STATS_H
+#define BBSORT_SOLUTION_POOL_STATS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace pool {
+
+    ///Pool statistics are collected only when BB_SORT_POOL_STATS is defined, otherwise recording compiles to nothing.
+#ifdef BB_SORT_POOL_STATS
+    constexpr bool poolStatsEnabled = true;
+#else
+    constexpr bool poolStatsEnabled = false;
+#endif
+
+    ///Number of size classes tracked, larger size classes share the last slot.
+    constexpr int statsClasses = 33;
+
+    struct size_class_stats {
+
+        long int Rents = 0;
+        long int Hits = 0;
+        long int Misses = 0;
+        long int Returns = 0;
+
+        ///Bytes rented and not returned yet, may go below zero for a class when arrays are returned across reset.
+        long int BytesOutstanding = 0;
+        long int PeakBytes = 0;
+
+        void add(const size_class_stats & other) {
+
+            Rents += other.Rents;
+            Hits += other.Hits;
+            Misses += other.Misses;
+            Returns += other.Returns;
+            BytesOutstanding += other.BytesOutstanding;
+            PeakBytes += other.PeakBytes;
+        }
+
+        void reset() {
+
+            Rents = Hits = Misses = Returns = 0;
+            PeakBytes = std::max(0l, BytesOutstanding);
+        }
+    };
+
+    struct pool_stats_snapshot {
+
+        size_class_stats Classes[statsClasses];
+
+        ///Sums of all classes, peak is the high-water mark of all classes together.
+        size_class_stats Total;
+
+        double getHitRate() const { return Total.Rents == 0 ? 0.0 : (double) Total.Hits / Total.Rents; }
+
+        ///Adds stats of other pool, peaks are summed as well.
+        void add(const pool_stats_snapshot & other) {
+
+            for (int i = 0; i < statsClasses; ++i) {
+
+                Classes[i].add(other.Classes[i]);
+            }
+
+            Total.add(other.Total);
+        }
+
+        void reset() {
+
+            for (auto & sizeClass : Classes) {
+
+                sizeClass.reset();
+            }
+
+            Total.reset();
+        }
+    };
+
+    ///Counters of a single pool, recorded by the thread using the pool only. They are relaxed atomics written
+    ///without read-modify-write, so recording takes no locked instructions and snapshots may read them from any thread.
+    class pool_stats {
+
+        struct counters {
+
+            std::atomic<long int> Rents = 0;
+            std::atomic<long int> Hits = 0;
+            std::atomic<long int> Misses = 0;
+            std::atomic<long int> Returns = 0;
+            std::atomic<long int> BytesOutstanding = 0;
+            std::atomic<long int> PeakBytes = 0;
+
+            void rent(long int bytes) {
+
+                add(Rents, 1);
+                add(BytesOutstanding, bytes);
+
+                const long int outstanding = BytesOutstanding.load(std::memory_order_relaxed);
+
+                if (outstanding > PeakBytes.load(std::memory_order_relaxed)) {
+
+                    PeakBytes.store(outstanding, std::memory_order_relaxed);
+                }
+            }
+
+            void giveBack(long int bytes) {
+
+                add(Returns, 1);
+                add(BytesOutstanding, -bytes);
+            }
+
+            size_class_stats read() const {
+
+                size_class_stats stats;
+
+                stats.Rents = Rents.load(std::memory_order_relaxed);
+                stats.Hits = Hits.load(std::memory_order_relaxed);
+                stats.Misses = Misses.load(std::memory_order_relaxed);
+                stats.Returns = Returns.load(std::memory_order_relaxed);
+                stats.BytesOutstanding = BytesOutstanding.load(std::memory_order_relaxed);
+                stats.PeakBytes = PeakBytes.load(std::memory_order_relaxed);
+
+                return stats;
+            }
+
+            void reset() {
+
+                Rents.store(0, std::memory_order_relaxed);
+                Hits.store(0, std::memory_order_relaxed);
+                Misses.store(0, std::memory_order_relaxed);
+                Returns.store(0, std::memory_order_relaxed);
+                PeakBytes.store(std::max(0l, BytesOutstanding.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+            }
+        };
+
+        static void add(std::atomic<long int> & counter, long int value) {
+
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        counters classes[statsClasses];
+        counters total;
+
+    public:
+
+        constexpr pool_stats() {
+        }
+
+        ///Records rent of array of size class, hit when it was served by an idle array.
+        void rent(int sizeClass, std::size_t bytes, bool hit) {
+
+            if constexpr (poolStatsEnabled) {
+
+                counters & target = classes[std::min(sizeClass, statsClasses - 1)];
+
+                add(hit ? target.Hits : target.Misses, 1);
+                add(hit ? total.Hits : total.Misses, 1);
+
+                target.rent(bytes);
+                total.rent(bytes);
+            }
+        }
+
+        void giveBack(int sizeClass, std::size_t bytes) {
+
+            if constexpr (poolStatsEnabled) {
+
+                classes[std::min(sizeClass, statsClasses - 1)].giveBack(bytes);
+                total.giveBack(bytes);
+            }
+        }
+
+        pool_stats_snapshot snapshot() const {
+
+            pool_stats_snapshot snapshot;
+
+            for (int i = 0; i < statsClasses; ++i) {
+
+                snapshot.Classes[i] = classes[i].read();
+            }
+
+            snapshot.Total = total.read();
+
+            return snapshot;
+        }
+
+        ///Zeroes counters, peaks restart from bytes outstanding now.
+        void reset() {
+
+            for (auto & sizeClass : classes) {
+
+                sizeClass.reset();
+            }
+
+            total.reset();
+        }
+    };
+
+    ///Stats of thread caches backed by the same shared pool. Every cache records to own counters, snapshot sums them,
+    ///so threads do not contend on shared counters. Peaks of caches are summed too, which bounds the real peak from above.
+    ///Caches register only when BB_SORT_POOL_STATS is defined, counters of destroyed caches stay in the sums.
+    class pool_stats_registry {
+
+        std::mutex lock;
+
+        std::vector<pool_stats *> members;
+
+        pool_stats_snapshot retired;
+
+    public:
+
+        constexpr pool_stats_registry() {
+        }
+
+        void add(pool_stats * stats) {
+
+            if constexpr (poolStatsEnabled) {
+
+                std::lock_guard<std::mutex> guard(lock);
+
+                members.push_back(stats);
+            }
+        }
+
+        void remove(pool_stats * stats) {
+
+            if constexpr (poolStatsEnabled) {
+
+                std::lock_guard<std::mutex> guard(lock);
+
+                retired.add(stats->snapshot());
+
+                members.erase(std::find(members.begin(), members.end(), stats));
+            }
+        }
+
+        pool_stats_snapshot snapshot() {
+
+            std::lock_guard<std::mutex> guard(lock);
+
+            pool_stats_snapshot snapshot = retired;
+
+            for (pool_stats * stats : members) {
+
+                snapshot.add(stats->snapshot());
+            }
+
+            return snapshot;
+        }
+
+        ///Zeroes counters of all caches, rents recorded by other threads meanwhile may be lost.
+        void reset() {
+
+            std::lock_guard<std::mutex> guard(lock);
+
+            retired.reset();
+
+            for (pool_stats * stats : members) {
+
+                stats->reset();
+            }
+        }
+    };
+}
+
+#endif //BBSORT_SOLUTION_POOL_STATS_H
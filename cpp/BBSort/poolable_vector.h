@@ -7,7 +7,8 @@
 #include <stdexcept>
 #include <iterator>
 #include <string>
-#include <global_array_pool.h>
+#include <sstream>
+#include <memory_scope.h>
 
 #include <fastmemcpy.h>
 
@@ -39,6 +40,11 @@ namespace pool {
         array_pointer          array = nullptr;
         size_type              length = 0;
 
+    private:
+
+        std::pmr::memory_resource * resource = nullptr;
+
+    public:
 
         vector(size_type size) :
                 capacity(0),
@@ -122,11 +128,6 @@ namespace pool {
                 , length(0)
                 , array(nullptr) {
 
-            if (capacity > 0) {
-
-                returnArrayToPool(array, capacity);
-            }
-
             move.swap(*this);
         }
 
@@ -142,6 +143,7 @@ namespace pool {
             swap(capacity, other.capacity);
             swap(length, other.length);
             swap(array, other.array);
+            swap(resource, other.resource);
         }
 
         // Non-Mutating functions
@@ -271,11 +273,12 @@ namespace pool {
 
     private:
 
-        vector(array_pointer array, size_type capacity)
+        vector(array_pointer array, size_type capacity, std::pmr::memory_resource * resource)
                 :
                 capacity(capacity),
                 array(array),
-                length(0) {
+                length(0),
+                resource(resource) {
         }
 
         void validateIndex(size_type index) const {
@@ -299,9 +302,11 @@ namespace pool {
 
             if (newCapacity > 0) {
 
-                array_pointer rentedArray = global_array_pool<T>::GLOBAL_POOL.rentArray(newCapacity);
+                std::pmr::memory_resource * rentedResource;
+
+                array_pointer rentedArray = rentScopeArray<T>(newCapacity, rentedResource);
 
-                vector tmpVector = vector(rentedArray, newCapacity);
+                vector tmpVector = vector(rentedArray, newCapacity, rentedResource);
 
                 if (length > 0) {
 
@@ -314,7 +319,7 @@ namespace pool {
 
         void returnArrayToPool(size_type size) {
 
-            global_array_pool<T>::GLOBAL_POOL.returnArray(array, size);
+            returnScopeArray<T>(array, size, resource);
         }
 
         void pushBackInternal(T const& value) {
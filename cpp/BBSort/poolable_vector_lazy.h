@@ -1,6 +1,10 @@
 #ifndef BBSORT_SOLUTION_POOLABLE_VECTOR_LAZY_H
 #define BBSORT_SOLUTION_POOLABLE_VECTOR_LAZY_H
 
+#include <cstdint>
+
+#include "poolable_vector.h"
+
 namespace pool {
 
     template<typename T>
@@ -23,10 +27,12 @@ namespace pool {
     private:
 
         size_type capacity = 0;
-        std::vector<bool> initFlags;
+        ///Bit per item, set once item is initialized. Words are rented from pool, bits above length are kept clear.
+        pool::vector<uint64_t> initFlags;
         bool lazyInit = false;
         size_type length = 0;
         array_pointer array = nullptr;
+        std::pmr::memory_resource * resource = nullptr;
 
     public:
 
@@ -38,7 +44,7 @@ namespace pool {
 
             lazyInit = true;
 
-            initFlags.resize(size);
+            growFlags(size);
 
             length = size;
         }
@@ -83,7 +89,7 @@ namespace pool {
         bool  hasBack() {
 
             if (lazyInit) {
-                return length > 0 && initFlags[length - 1];
+                return length > 0 && isInit(length - 1);
             }
 
             return length > 0;
@@ -91,7 +97,7 @@ namespace pool {
 
         reference  back() {
 
-            if (lazyInit && !initFlags[length - 1]) {
+            if (lazyInit && !isInit(length - 1)) {
                 initBack(length - 1);
             }
 
@@ -107,17 +113,19 @@ namespace pool {
         vector_lazy(vector_lazy &&move) noexcept
                 : capacity(0), length(0), array(nullptr) {
 
-            if (capacity > 0) {
-
-                returnArrayToPool(array, capacity);
-            }
-
             move.swap(*this);
+
+            initFlags.swap(move.initFlags);
+            std::swap(lazyInit, move.lazyInit);
         }
 
         vector_lazy &operator=(vector_lazy &&move) noexcept {
 
             move.swap(*this);
+
+            initFlags.swap(move.initFlags);
+            std::swap(lazyInit, move.lazyInit);
+
             return *this;
         }
 
@@ -127,6 +135,7 @@ namespace pool {
             swap(capacity, other.capacity);
             swap(length, other.length);
             swap(array, other.array);
+            swap(resource, other.resource);
         }
 
         // Non-Mutating functions
@@ -139,7 +148,7 @@ namespace pool {
 
             validateIndex(index);
 
-            if (lazyInit && !initFlags[index]) {
+            if (lazyInit && !isInit(index)) {
                 initBack(index);
             }
 
@@ -149,7 +158,7 @@ namespace pool {
         // Non-Validated element access
         reference operator[](size_type index) {
 
-            if (lazyInit && !initFlags[index]) {
+            if (lazyInit && !isInit(index)) {
                 initBack(index);
             }
             return array[index];
@@ -158,11 +167,50 @@ namespace pool {
         bool hasValue(size_type index) {
 
             if (lazyInit) {
-                return initFlags[index];
+                return isInit(index);
             }
             return true;
         }
 
+        ///Index of the last initialized item before index, -1 if there is none. Skips 64 empty items per word.
+        long int findPrevValue(long int index) const {
+
+            if (!lazyInit) {
+
+                return index - 1;
+            }
+
+            if (index <= 0) {
+
+                return -1;
+            }
+
+            long int word = (index - 1) >> 6;
+
+            uint64_t bits = initFlags.array[word] & (~UINT64_C(0) >> (63 - ((index - 1) & 63)));
+
+            while (bits == 0) {
+
+                if (--word < 0) {
+
+                    return -1;
+                }
+
+                bits = initFlags.array[word];
+            }
+
+            return (word << 6) + 63 - __builtin_clzll(bits);
+        }
+
+        ///Drops uninitialized items at the back, so back() is an initialized item or vector is empty.
+        void trimBack() {
+
+            if (lazyInit) {
+
+                length = findPrevValue(length) + 1;
+            }
+        }
+
         friend std::ostream &operator<<(std::ostream &os, const vector_lazy &m) {
 
             os << "lazy vector:  size: " << m.length << " , capacity: " << m.capacity << " , lazy init: " << m.lazyInit
@@ -174,7 +222,7 @@ namespace pool {
 
                 if (m.lazyInit) {
 
-                    good = m.initFlags[i];
+                    good = m.isInit(i);
                 }
 
                 os << "[ " << i << "] = " << m.value << " good: " << good << std::endl;
@@ -222,8 +270,7 @@ namespace pool {
 
             if (lazyInit) {
 
-                initFlags.resize(length);
-                initFlags[length - 1] = true;
+                setInit(length - 1);
             }
         }
 
@@ -236,8 +283,7 @@ namespace pool {
 
             if (lazyInit) {
 
-                initFlags.resize(length);
-                initFlags[length - 1] = true;
+                setInit(length - 1);
             }
         }
 
@@ -251,8 +297,7 @@ namespace pool {
 
             if (lazyInit) {
 
-                initFlags.resize(length);
-                initFlags[length - 1] = true;
+                setInit(length - 1);
             }
         }
 
@@ -265,8 +310,7 @@ namespace pool {
 
             if (lazyInit) {
 
-                initFlags.resize(length);
-                initFlags[length - 1] = true;
+                setInit(length - 1);
             }
         }
 
@@ -278,8 +322,7 @@ namespace pool {
 
             if (lazyInit) {
 
-                initFlags.resize(length);
-                initFlags[length - 1] = true;
+                setInit(length - 1);
             }
         }
 
@@ -287,9 +330,15 @@ namespace pool {
 
             --length;
 
-            if (!lazyInit || initFlags[length]) {
+            if (!lazyInit) {
+
+                array[length].~T();
+            }
+            else if (isInit(length)) {
 
                 array[length].~T();
+
+                initFlags.array[length >> 6] &= ~(UINT64_C(1) << (length & 63));
             }
         }
 
@@ -304,6 +353,28 @@ namespace pool {
             initFlags.clear();
         }
 
+        ///Destroys items and makes vector of size uninitialized items, array and init flags are reused.
+        void reset(size_type size) {
+
+            if (length > 0) {
+
+                clearElements<T>();
+
+                //bits above length are clear, so words up to length cover all set ones.
+                std::fill(initFlags.array, initFlags.array + std::min<size_type>((length + 63) >> 6, initFlags.length), 0);
+            }
+
+            length = 0;
+
+            reserve(size);
+
+            lazyInit = true;
+
+            growFlags(size);
+
+            length = size;
+        }
+
         void reserve(size_type capacityUpperBound) {
 
             if (capacityUpperBound > capacity) {
@@ -314,11 +385,12 @@ namespace pool {
 
     private:
 
-        vector_lazy(array_pointer array, size_type capacity)
+        vector_lazy(array_pointer array, size_type capacity, std::pmr::memory_resource * resource)
                 :
                 capacity(capacity),
                 array(array),
-                length(0) {
+                length(0),
+                resource(resource) {
         }
 
         void validateIndex(size_type index) const {
@@ -328,6 +400,33 @@ namespace pool {
             }
         }
 
+        bool isInit(size_type index) const {
+
+            return (initFlags.array[index >> 6] >> (index & 63)) & 1;
+        }
+
+        void setInit(size_type index) {
+
+            growFlags(index + 1);
+
+            initFlags.array[index >> 6] |= UINT64_C(1) << (index & 63);
+        }
+
+        void growFlags(size_type size) {
+
+            const size_type words = (size + 63) >> 6;
+
+            if (initFlags.length < words) {
+
+                initFlags.reserve(words);
+
+                while (initFlags.length < words) {
+
+                    initFlags.push_back(0);
+                }
+            }
+        }
+
         void resizeIfRequire() {
 
             if (length == capacity) {
@@ -341,9 +440,11 @@ namespace pool {
 
             if (newCapacity > 0) {
 
-                array_pointer rentedArray = global_array_pool<T>::GLOBAL_POOL.rentArray(newCapacity);
+                std::pmr::memory_resource * rentedResource;
 
-                vector_lazy tmpVector = vector_lazy(rentedArray, newCapacity);
+                array_pointer rentedArray = rentScopeArray<T>(newCapacity, rentedResource);
+
+                vector_lazy tmpVector = vector_lazy(rentedArray, newCapacity, rentedResource);
 
                 if (length > 0) {
 
@@ -356,7 +457,7 @@ namespace pool {
 
         void returnArrayToPool(size_type size) {
 
-            global_array_pool<T>::GLOBAL_POOL.returnArray(array, size);
+            returnScopeArray<T>(array, size, resource);
         }
 
         void pushBackInternal(T const &value) {
@@ -381,7 +482,7 @@ namespace pool {
         void initBack(size_type index) {
 
             new(array + index) T();
-            initFlags[index] = true;
+            setInit(index);
         }
 
         template<typename X>
@@ -414,7 +515,7 @@ namespace pool {
 
                 size_type index = length - 1 - loop;
 
-                if (!lazyInit || initFlags[index]) {
+                if (!lazyInit || isInit(index)) {
 
                     array[index].~T();
                 }
@@ -447,7 +548,10 @@ namespace pool {
 
                 if (lazyInit) {
 
-                    initFlags.resize(length);
+                    for (size_type i = 0; i < length; ++i) {
+
+                        setInit(i);
+                    }
                 }
             } else {
 
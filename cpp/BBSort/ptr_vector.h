@@ -27,7 +27,7 @@ namespace pool
 
         void deallocate(pointer buffer) {
 
-            free(buffer);
+            ::operator delete(buffer);
             capacity = 0;
         }
 
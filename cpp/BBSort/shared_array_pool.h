@@ -0,0 +1,150 @@
+#ifndef BBSORT_SOLUTION_SHARED_ARRAY_POOL_H
+#define BBSORT_SOLUTION_SHARED_ARRAY_POOL_H
+
+#include "array_pool_bucket.h"
+#include "pool_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace pool {
+
+    ///Backing pool behind thread caches. Caches exchange arrays with it in batches through lock-free free lists:
+    ///arrays given by a thread returning buckets rented elsewhere never wait, takes wait for other takes only.
+    template<typename T>
+    class shared_array_pool {
+
+        using array_pointer = T *;
+
+        using size_class = concurrent_object_pool<T>;
+
+    public:
+
+        static constexpr int sizeClasses = 32;
+
+        ///Arrays moved between thread cache and shared pool at once.
+        static constexpr int batchSize = 32;
+
+        ///Stats of all thread caches backed by this pool.
+        pool_stats_registry Stats;
+
+        constexpr shared_array_pool() {
+        }
+
+        static constexpr std::size_t getArrayLength(int sizeClass) {
+
+            return (std::size_t) 16 << sizeClass;
+        }
+
+        static constexpr std::size_t getArrayBytes(int sizeClass) {
+
+            return sizeof(T) * getArrayLength(sizeClass);
+        }
+
+        ///Sets caps on idle arrays, arrays given above them are released. Already kept arrays are released on trim.
+        void setLimits(const pool_limits & value) {
+
+            classBytesMax.store(value.ClassBytesMax, std::memory_order_relaxed);
+            totalBytesMax.store(value.TotalBytesMax, std::memory_order_relaxed);
+        }
+
+        pool_limits getLimits() const {
+
+            return {classBytesMax.load(std::memory_order_relaxed), totalBytesMax.load(std::memory_order_relaxed)};
+        }
+
+        std::size_t getIdleBytes() const {
+
+            return idleBytes.load(std::memory_order_relaxed);
+        }
+
+        ///Moves up to count arrays of size class to arrays, returns the number moved.
+        int take(int sizeClass, array_pointer * arrays, int count) {
+
+            count = classes[sizeClass].pop(arrays, count);
+
+            idleBytes.fetch_sub(count * getArrayBytes(sizeClass), std::memory_order_relaxed);
+
+            return count;
+        }
+
+        ///Keeps arrays within limits, releases the rest. Concurrent gives may exceed limits by a batch.
+        void give(int sizeClass, const array_pointer * arrays, int count) {
+
+            const std::size_t bytes = getArrayBytes(sizeClass);
+            const pool_limits current = getLimits();
+
+            size_class & target = classes[sizeClass];
+
+            const std::size_t idle = idleBytes.load(std::memory_order_relaxed);
+
+            int kept = 0;
+
+            for (; kept < count; ++kept) {
+
+                if ((target.size() + kept + 1) * bytes > current.ClassBytesMax ||
+                    idle + (kept + 1) * bytes > current.TotalBytesMax) {
+
+                    break;
+                }
+            }
+
+            target.push(arrays, kept);
+
+            idleBytes.fetch_add(kept * bytes, std::memory_order_relaxed);
+
+            for (int i = kept; i < count; ++i) {
+
+                releaseArray(arrays[i], bytes);
+            }
+        }
+
+        ///Releases idle arrays above keep limits, all of them by default. Largest arrays go first.
+        void trim(const pool_limits & keep = {0, 0}) {
+
+            for (int i = sizeClasses - 1; i >= 0; --i) {
+
+                const std::size_t bytes = getArrayBytes(i);
+
+                while (classes[i].size() * bytes > keep.ClassBytesMax ||
+                       idleBytes.load(std::memory_order_relaxed) > keep.TotalBytesMax) {
+
+                    array_pointer array = classes[i].pop();
+
+                    if (array == nullptr) {
+
+                        break;
+                    }
+
+                    idleBytes.fetch_sub(bytes, std::memory_order_relaxed);
+
+                    releaseArray(array, bytes);
+                }
+            }
+        }
+
+        ~shared_array_pool() {
+
+            for (int i = 0; i < sizeClasses; ++i) {
+
+                while (array_pointer array = classes[i].pop()) {
+
+                    freeArray(array, getArrayBytes(i));
+                }
+            }
+        }
+
+    private:
+
+        size_class classes[sizeClasses];
+
+        //limits are read by every give, so they are kept in atomics instead of behind a lock.
+        std::atomic<std::size_t> classBytesMax = pool_limits().ClassBytesMax;
+        std::atomic<std::size_t> totalBytesMax = pool_limits().TotalBytesMax;
+
+        std::atomic<std::size_t> idleBytes = 0;
+    };
+}
+
+#endif //BBSORT_SOLUTION_SHARED_ARRAY_POOL_H
@@ -0,0 +1,205 @@
+#ifndef BBSORT_SOLUTION_WORK_STEALING_POOL_H
+#define BBSORT_SOLUTION_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+    ///Fixed size thread pool. Every worker owns a task deque: it pushes and pops own tasks from the back,
+    ///idle workers steal the oldest tasks from the front of others deques.
+    ///Thread called wait() works as worker 0 until all submitted tasks are done.
+    class work_stealing_pool {
+
+        using task = std::function<void()>;
+
+        struct task_queue {
+
+            std::mutex lock;
+            std::deque<task> tasks;
+        };
+
+    public:
+
+        work_stealing_pool(unsigned int threadCount) {
+
+            threadCount = std::max(1u, threadCount);
+
+            for (unsigned int i = 0; i < threadCount; ++i) {
+
+                queues.emplace_back(std::make_unique<task_queue>());
+            }
+
+            for (unsigned int i = 1; i < threadCount; ++i) {
+
+                threads.emplace_back([this, i] { workerLoop(i); });
+            }
+        }
+
+        ~work_stealing_pool() {
+
+            {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                stopping = true;
+            }
+
+            wakeUp.notify_all();
+
+            for (auto & thread : threads) {
+
+                thread.join();
+            }
+        }
+
+        unsigned int size() const {  return queues.size(); }
+
+        void submit(task func) {
+
+            pending.fetch_add(1, std::memory_order_relaxed);
+
+            int index = currentPool == this ? currentWorker : 0;
+
+            {
+                std::lock_guard<std::mutex> guard(queues[index]->lock);
+                queues[index]->tasks.emplace_back(std::move(func));
+            }
+
+            wakeUp.notify_one();
+        }
+
+        ///Runs tasks on the calling thread until every submitted task, including nested ones, is done.
+        void wait() {
+
+            currentPool = this;
+            currentWorker = 0;
+
+            while (pending.load(std::memory_order_acquire) > 0) {
+
+                if (!runNext(0)) {
+
+                    std::this_thread::yield();
+                }
+            }
+
+            currentPool = nullptr;
+        }
+
+    private:
+
+        std::vector<std::unique_ptr<task_queue>> queues;
+        std::vector<std::thread> threads;
+
+        std::atomic<long> pending{0};
+        bool stopping = false;
+
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+
+        static inline thread_local work_stealing_pool * currentPool = nullptr;
+        static inline thread_local int currentWorker = 0;
+
+        bool pop(int index, task & func) {
+
+            std::lock_guard<std::mutex> guard(queues[index]->lock);
+
+            if (queues[index]->tasks.empty()) {
+
+                return false;
+            }
+
+            func = std::move(queues[index]->tasks.back());
+            queues[index]->tasks.pop_back();
+
+            return true;
+        }
+
+        bool steal(int index, task & func) {
+
+            std::lock_guard<std::mutex> guard(queues[index]->lock);
+
+            if (queues[index]->tasks.empty()) {
+
+                return false;
+            }
+
+            func = std::move(queues[index]->tasks.front());
+            queues[index]->tasks.pop_front();
+
+            return true;
+        }
+
+        bool runNext(int index) {
+
+            task func;
+
+            bool found = pop(index, func);
+
+            for (int i = 1; !found && i < queues.size(); ++i) {
+
+                found = steal((index + i) % queues.size(), func);
+            }
+
+            if (!found) {
+
+                return false;
+            }
+
+            func();
+
+            pending.fetch_sub(1, std::memory_order_release);
+
+            return true;
+        }
+
+        void workerLoop(int index) {
+
+            currentPool = this;
+            currentWorker = index;
+
+            while (true) {
+
+                if (runNext(index)) {
+
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> guard(sleepLock);
+
+                if (stopping) {
+
+                    return;
+                }
+
+                wakeUp.wait_for(guard, std::chrono::milliseconds(1));
+            }
+        }
+    };
+
+    ///Runs func(t, begin, end) for threadCount equal slices of [0, size), slice 0 on the calling thread.
+    template<typename Func>
+    void forEachSlice(long int size, unsigned int threadCount, Func func) {
+
+        std::vector<std::thread> threads;
+
+        for (unsigned int t = 1; t < threadCount; ++t) {
+
+            threads.emplace_back(func, t, (size * t) / threadCount, (size * (t + 1)) / threadCount);
+        }
+
+        func(0, 0, size / threadCount);
+
+        for (auto & thread : threads) {
+
+            thread.join();
+        }
+    }
+}
+
+#endif //BBSORT_SOLUTION_WORK_STEALING_POOL_H
@@ -4,9 +4,16 @@
 #include <bb_sort_get_top_n_lazy.h>
 #include <bb_sort_dictless.h>
 #include <bb_sort_dictless_min_max_vect.h>
+#include <bb_sort_dictless_prefix_sum.h>
+#include <bb_sort_dict_deferred.h>
+#include <bucket_stack.h>
+#include <counted_bucket.h>
+#include <bb_sort_sorter.h>
 #include <min_max_heap.h>
 #include <vector>
 #include <random>
+#include <limits>
+#include <set>
 #include <chrono>
 
 //https://github.com/boost-ext/ut#tutorial
@@ -40,76 +47,1255 @@ void sort_and_test(std::vector<T> arr){
     std::vector<T> arrCopy3(arr);
     std::reverse(arrCopy3.begin(), arrCopy3.end());
 
+    std::vector<T> arrCopy4(arr);
+    std::reverse(arrCopy4.begin(), arrCopy4.end());
+
+    std::vector<T> arrCopy5(arr);
+    std::reverse(arrCopy5.begin(), arrCopy5.end());
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    bb_sort::sort(arrCopy);
+    bb_sort_dictless::sort(arrCopy2);
+    bb_sort_dictless_min_max_vect::sort(arrCopy3);
+    bb_sort_dictless_prefix_sum::sort(arrCopy4);
+    bb_sort_dict_deferred::sort(arrCopy5);
+
+    test_arrays<T>(arrCopy, goldenArr);
+    test_arrays<T>(arrCopy2, goldenArr);
+    test_arrays<T>(arrCopy3, goldenArr);
+    test_arrays<T>(arrCopy4, goldenArr);
+    test_arrays<T>(arrCopy5, goldenArr);
+}
+
+void test_bucket_worst_1() {
+
+    std::cout << "test_bucket_worst_1" << std::endl;
+
+    std::vector<float> arr = {0.0001, 0.0002, 0.0003, 1, 2, 3, 10, 20, 30, 100, 200, 300, 1000, 2000, 3000};
+
+    sort_and_test(arr);
+}
+
+void test_bucket_worst_2() {
+
+    std::cout << "test_bucket_worst_2" << std::endl;
+
+    std::vector<double> bucket_worse_arr;
+    std::vector<double> arrt = {0.000000000001, 0.000000000002, 0.000000000003};
+    double cluster = 10.0;
+
+    for (int i = 0; i < 15; ++i) {
+
+        for (auto const val : arrt) {
+            bucket_worse_arr.emplace_back(val * cluster);
+            cluster *= 10.0;
+        }
+    }
+    sort_and_test(bucket_worse_arr);
+}
+
+
+void  test_negative_ints() {
+
+    std::cout << "test_negative_ints" << std::endl;
+
+    std::vector<int> arr = {-5, -10, 0, -3, 8, 5, -1, 10};
+    sort_and_test(arr);
+}
+
+void test_huge_gap(){
+
+    std::cout << "test_huge_gap" << std::endl;
+
+    std::vector<long> arr = {9, 8, 7, 1, 1000000000};
+    sort_and_test(arr);
+}
+
+void test_float_huge_gap(){
+
+    std::cout << "test_float_huge_gap" << std::endl;
+
+    std::vector<float> arr = {0.9, 0.8, 0.7, 0.1, 1000000000};
+    sort_and_test(arr);
+}
+
+void test_duplicates(){
+
+    std::cout << "test_duplicates" << std::endl;
+
+    std::vector<float> arr = {10, 20, 40, 50, 60, 69, 70, 70 , 70 , 70 , 70};
+    sort_and_test(arr);
+}
+
+template <typename T>
+void test_parallel_top_buckets(){
+
+    std::cout << "test_parallel_top_buckets " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(42);
+    std::uniform_int_distribution<int> dist(-1000000, 1000000);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 300000; ++i) {
+        arr.emplace_back(dist(g));
+    }
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    std::vector<T> singleThread(arr);
+    bb_sort_dictless_min_max_vect::sort(singleThread);
+
+    std::vector<T> multiThread(arr);
+    bb_sort_dictless_min_max_vect::sortParallel(multiThread, 4);
+
+    test_arrays<T>(singleThread, goldenArr);
+    test_arrays<T>(multiThread, goldenArr);
+}
+
+template <typename T>
+void test_parallel_bucket_tasks(){
+
+    std::cout << "test_parallel_bucket_tasks " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(7);
+    std::lognormal_distribution<double> dist(8.0, 3.0);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 400000; ++i) {
+        arr.emplace_back(dist(g));
+    }
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    std::vector<T> arrCopy(arr);
+    std::vector<T> arrCopy2(arr);
+    std::vector<T> arrCopy3(arr);
+
+    bb_sort::sortParallel(arrCopy, 4);
+    bb_sort_dictless::sortParallel(arrCopy2, 4);
+    bb_sort_dictless_min_max_vect::sortParallel(arrCopy3, 4);
+
+    test_arrays<T>(arrCopy, goldenArr);
+    test_arrays<T>(arrCopy2, goldenArr);
+    test_arrays<T>(arrCopy3, goldenArr);
+}
+
+template <typename T>
+void test_prefix_sum_scatter(){
+
+    std::cout << "test_prefix_sum_scatter " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(11);
+    std::lognormal_distribution<double> dist(8.0, 3.0);
+    std::uniform_int_distribution<int> duplicates(0, 3);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 200000; ++i) {
+        arr.emplace_back(i % 5 == 0 ? duplicates(g) : dist(g));
+    }
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    bb_sort_dictless_prefix_sum::sort(arr);
+
+    test_arrays<T>(arr, goldenArr);
+}
+
+template <typename T>
+void test_bucket_map_kernel(){
+
+    std::cout << "test_bucket_map_kernel " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(5);
+    std::lognormal_distribution<double> dist(2.0, 6.0);
+    std::uniform_int_distribution<int> sign(0, 1);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 10007; ++i) {
+        double value = dist(g);
+        arr.emplace_back(sign(g) ? value : -value);
+    }
+
+    T min = *std::min_element(arr.begin(), arr.end());
+    T max = *std::max_element(arr.begin(), arr.end());
+
+    const bb_sort::log_bucket_map<T> map(min, max, 1024);
+
+    std::vector<int> indexes(arr.size());
+    map.getIndexes(arr.data(), arr.size(), indexes.data());
+
+    std::vector<int> goldenIndexes;
+
+    for (auto & item : arr) {
+        goldenIndexes.emplace_back(map.getIndex(item));
+    }
+
+    test_arrays<int>(indexes, goldenIndexes);
+}
+
+template <typename T>
+void test_integer_bucket_map(){
+
+    std::cout << "test_integer_bucket_map " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(3);
+    std::uniform_int_distribution<T> offset(0, 1000000);
+
+    const T base = std::numeric_limits<T>::max() / 3;
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 100000; ++i) {
+        T value = base + offset(g);
+        arr.emplace_back(i % 7 == 0 ? -value : value);
+    }
+
+    arr.emplace_back(std::numeric_limits<T>::max());
+    arr.emplace_back(std::numeric_limits<T>::min());
+    arr.emplace_back(0);
+
+    const bb_sort::bucket_map<T> map(base, base + 1, 2);
+
+    boost::ut::expect(map.getIndex(base) == 0);
+    boost::ut::expect(map.getIndex(base + 1) == 1);
+
+    sort_and_test(arr);
+}
+
+template <typename T>
+void test_ordered_bits_bucket_map(){
+
+    std::cout << "test_ordered_bits_bucket_map " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(9);
+    std::uniform_int_distribution<int> ulps(0, 100000);
+
+    const T base = 1000000;
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 100000; ++i) {
+        T value = base;
+        for (int ulp = ulps(g) % 64; ulp > 0; --ulp) {
+            value = std::nextafter(value, std::numeric_limits<T>::max());
+        }
+        arr.emplace_back(i % 5 == 0 ? -value : value);
+    }
+
+    const T next = std::nextafter(base, std::numeric_limits<T>::max());
+    const bb_sort::bucket_map<T> map(base, next, 2);
+
+    boost::ut::expect(map.getIndex(base) == 0);
+    boost::ut::expect(map.getIndex(next) == 1);
+
+    sort_and_test(arr);
+}
+
+template <typename T>
+void test_bucket_map_keys(T base){
+
+    std::cout << "test_bucket_map_keys " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(21);
+    std::lognormal_distribution<double> spread(2.0, 8.0);
+
+    auto testRange = [&](T min, T max, bb_sort::mapping mode) {
+
+        const bb_sort::bucket_map<T> map(min, max, 1000);
+
+        boost::ut::expect(map.Mode == mode);
+
+        std::vector<T> arr = {min, max, 0};
+
+        for (int i = 0; i < 1001; ++i) {
+
+            const double value = i % 2 == 0 ? spread(g) : -spread(g);
+            arr.emplace_back((T) std::clamp(value, (double) min, (double) max));
+            arr.emplace_back(i % 3 == 0 ? min + (T) (i % 61) : max - (T) (i % 67));
+        }
+
+        arr.erase(std::remove_if(arr.begin(), arr.end(), [&](const T & item) { return item < min || item > max; }), arr.end());
+
+        std::vector<int> indexes(arr.size());
+        map.getIndexes(arr.data(), arr.size(), indexes.data());
+
+        std::vector<int> goldenIndexes;
+
+        for (auto & item : arr) {
+            goldenIndexes.emplace_back(map.getIndex(item));
+        }
+
+        test_arrays<int>(indexes, goldenIndexes);
+    };
+
+    testRange(base, base + base / 32, bb_sort::mapping::Linear);
+    testRange(base / 4, base, bb_sort::mapping::OffsetLog);
+    testRange(0, base, bb_sort::mapping::OffsetLog);
+
+    if constexpr (std::is_signed_v<T>) {
+
+        testRange(-base, base, bb_sort::mapping::Log);
+        testRange(-base, -base / 4, bb_sort::mapping::OffsetLog);
+        testRange(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(), std::is_integral_v<T> ? bb_sort::mapping::Log : bb_sort::mapping::Linear);
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+
+        testRange(-std::numeric_limits<T>::infinity(), std::numeric_limits<T>::infinity(), bb_sort::mapping::Linear);
+        testRange(-1, std::numeric_limits<T>::denorm_min(), bb_sort::mapping::Log);
+    }
+}
+
+template <typename T>
+void test_adaptive_bucket_map(T base){
+
+    std::cout << "test_adaptive_bucket_map " << typeid(T).name() << std::endl;
+
+    boost::ut::expect(bb_sort::bucket_map<T>(-base, base, 1024).Mode == bb_sort::mapping::Log);
+    boost::ut::expect(bb_sort::bucket_map<T>(base, base + base / 32, 1024).Mode == bb_sort::mapping::Linear);
+    boost::ut::expect(bb_sort::bucket_map<T>(base / 4, base, 1024).Mode == bb_sort::mapping::OffsetLog);
+    boost::ut::expect(bb_sort::bucket_map<T>(-base, -base / 4, 1024).Mode == bb_sort::mapping::OffsetLog);
+
+    std::mt19937 g(13);
+    std::lognormal_distribution<double> offset(4.0, 4.0);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 100000; ++i) {
+        T value = base + (T) std::min(offset(g), (double) base * 2);
+        arr.emplace_back(i % 3 == 0 ? -value : value);
+    }
+
+    sort_and_test(arr);
+}
+
+template <typename T>
+void test_infinite_floats(){
+
+    std::cout << "test_infinite_floats " << typeid(T).name() << std::endl;
+
+    const T inf = std::numeric_limits<T>::infinity();
+
+    boost::ut::expect(bb_sort::bucket_map<T>(-inf, inf, 128).Mode == bb_sort::mapping::Linear);
+    boost::ut::expect(bb_sort::bucket_map<T>(5, inf, 128).Mode == bb_sort::mapping::Linear);
+    boost::ut::expect(bb_sort::bucket_map<T>(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(), 128).Mode == bb_sort::mapping::Linear);
+
+    std::mt19937 g(59);
+    std::uniform_real_distribution<T> dist(-1000, 1000);
+
+    for (int size : {200, 40000}) {
+
+        std::vector<T> arr = {5, 1, inf, 3, 2, -inf, std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest(), inf, -inf};
+
+        for (int i = 0; i < size; ++i) {
+            arr.push_back(dist(g));
+        }
+
+        std::vector<T> goldenArr(arr);
+        sort(goldenArr.begin(), goldenArr.end());
+
+        auto testSort = [&](auto sortFunc) {
+
+            std::vector<T> sorted(arr);
+            sortFunc(sorted);
+
+            test_arrays<T>(sorted, goldenArr);
+        };
+
+        testSort([](auto & array) { bb_sort::sort(array); });
+        testSort([](auto & array) { bb_sort::sortParallel(array, 2); });
+        testSort([](auto & array) { bb_sort_dictless::sort(array); });
+        testSort([](auto & array) { bb_sort_dictless::sortParallel(array, 2); });
+        testSort([](auto & array) { bb_sort_dictless_min_max_vect::sort(array); });
+        testSort([](auto & array) { bb_sort_dictless_min_max_vect::sort(array, bb_sort::top_mapping::Cdf); });
+        testSort([](auto & array) { bb_sort_dictless_min_max_vect::sortParallel(array, 2); });
+        testSort([](auto & array) { bb_sort_dict_deferred::sort(array); });
+        testSort([](auto & array) { bb_sort_dictless_prefix_sum::sort(array); });
+        testSort([](auto & array) { bb_sort::sorter<T>().sort(array); });
+
+        const long int topN = 100;
+
+        std::vector<T> goldenTop(goldenArr.begin(), goldenArr.begin() + topN);
+
+        test_arrays<T>(bb_sort::getTopSorted(arr, topN), goldenTop);
+        test_arrays<T>(bb_sort_top_n_lazy::getTopSortedLazy(arr, topN), goldenTop);
+        test_arrays<T>(bb_sort::sorter<T>().getTopSorted(arr, topN), goldenTop);
+    }
+}
+
+template <typename T>
+void test_counting_sort(){
+
+    std::cout << "test_counting_sort " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(17);
+    std::uniform_int_distribution<int> codes(-500, 500);
+    std::uniform_int_distribution<int> wide(0, 30000);
+
+    std::vector<T> narrow;
+    std::vector<T> clustered;
+
+    for (int i = 0; i < 100000; ++i) {
+        narrow.emplace_back(codes(g));
+        clustered.emplace_back(i % 10 == 0 ? wide(g) : 20000 + codes(g));
+    }
+
+    boost::ut::expect(bb_sort_counting::isDense<T>(-500, 500, narrow.size()));
+    boost::ut::expect(!bb_sort_counting::isDense<T>(0, 30000, 1000));
+
+    sort_and_test(narrow);
+    sort_and_test(clustered);
+
+    std::vector<T> goldenTop(clustered);
+    sort(goldenTop.begin(), goldenTop.end());
+    goldenTop.resize(1000);
+
+    test_arrays<T>(bb_sort::getTopSorted(clustered, 1000), goldenTop);
+
+    std::vector<T> goldenArr(clustered);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    bb_sort_dictless_min_max_vect::sortParallel(clustered, 4);
+
+    test_arrays<T>(clustered, goldenArr);
+}
+
+template <typename T>
+void test_radix_sort(T base, T step){
+
+    std::cout << "test_radix_sort " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(19);
+    std::uniform_int_distribution<int> offset(0, 50000);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 5000; ++i) {
+        arr.emplace_back(base + step * offset(g));
+    }
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    const T min = goldenArr.front();
+    const T max = goldenArr.back();
+
+    std::vector<T> scratch(arr.size());
+    std::vector<T> radixSorted(arr);
+
+    T * sorted = bb_sort_radix::sort(radixSorted.data(), scratch.data(), radixSorted.size(), min, max);
+
+    test_arrays<T>(std::vector<T>(sorted, sorted + arr.size()), goldenArr);
+
+    sort_and_test(arr);
+}
+
+template <typename T>
+void test_cdf_bucket_map(){
+
+    std::cout << "test_cdf_bucket_map " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(23);
+    std::normal_distribution<double> near(1000.0, 50.0);
+    std::lognormal_distribution<double> far(20.7, 0.5);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 20000; ++i) {
+        arr.emplace_back((T) (i % 2 == 0 ? near(g) : far(g)));
+    }
+
+    const auto [min, max] = std::minmax_element(arr.begin(), arr.end());
+
+    const int count = 1024;
+
+    const bb_sort::bucket_map<T> keys(*min, *max, count);
+    const bb_sort::cdf_bucket_map<T> cdf(arr.data(), arr.size(), *min, *max, count);
+
+    const auto keysBalance = bb_sort::getBucketBalance(keys, arr.data(), arr.size(), count);
+    const auto cdfBalance = bb_sort::getBucketBalance(cdf, arr.data(), arr.size(), count);
+
+    boost::ut::expect(cdfBalance.NonEmpty > keysBalance.NonEmpty);
+    boost::ut::expect(cdfBalance.Largest < keysBalance.Largest);
+
     std::vector<T> goldenArr(arr);
     sort(goldenArr.begin(), goldenArr.end());
 
-    bb_sort::sort(arrCopy);
-    bb_sort_dictless::sort(arrCopy2);
-    bb_sort_dictless_min_max_vect::sort(arrCopy3);
+    std::vector<T> cdfSorted(arr);
+    bb_sort_dictless_min_max_vect::sort(cdfSorted, bb_sort::top_mapping::Cdf);
+
+    test_arrays<T>(cdfSorted, goldenArr);
+}
+
+template <typename T>
+void test_heavy_hitters(){
+
+    std::cout << "test_heavy_hitters " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(29);
+    std::uniform_int_distribution<int> share(0, 99);
+    std::uniform_int_distribution<long> wide(-1000000000l, 1000000000l);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 100000; ++i) {
+
+        const int s = share(g);
+
+        arr.emplace_back(s < 40 ? (T) 0 : s < 55 ? (T) -1 : (T) wide(g));
+    }
+
+    const auto hitters = bb_sort_heavy::getHeavyHitters(arr.data(), arr.size());
+
+    boost::ut::expect(hitters.Count == 2);
+    boost::ut::expect(hitters.Values[0] == (T) -1);
+    boost::ut::expect(hitters.Values[1] == (T) 0);
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    std::vector<T> dictless(arr);
+    bb_sort_dictless::sort(dictless);
+    test_arrays<T>(dictless, goldenArr);
+
+    std::vector<T> dictlessParallel(arr);
+    bb_sort_dictless::sortParallel(dictlessParallel, 4);
+    test_arrays<T>(dictlessParallel, goldenArr);
+
+    std::vector<T> minMaxVect(arr);
+    bb_sort_dictless_min_max_vect::sort(minMaxVect);
+    test_arrays<T>(minMaxVect, goldenArr);
+
+    std::vector<T> minMaxVectCdf(arr);
+    bb_sort_dictless_min_max_vect::sort(minMaxVectCdf, bb_sort::top_mapping::Cdf);
+    test_arrays<T>(minMaxVectCdf, goldenArr);
+}
+
+template <typename T>
+void test_dict_deferred(){
+
+    std::cout << "test_dict_deferred " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(31);
+    std::uniform_int_distribution<long> wide(-1000000000l, 1000000000l);
+
+    std::vector<T> distinct;
+
+    for (int i = 0; i < 5000; ++i) {
+        distinct.emplace_back((T) wide(g));
+    }
+
+    std::uniform_int_distribution<int> pick(0, distinct.size() - 1);
+
+    std::vector<T> lowCardinality;
+    std::vector<T> highCardinality;
+
+    for (int i = 0; i < 200000; ++i) {
+        lowCardinality.emplace_back(distinct[pick(g)]);
+        highCardinality.emplace_back((T) wide(g));
+    }
+
+    for (auto arr : {lowCardinality, highCardinality}) {
+
+        std::vector<T> goldenArr(arr);
+        sort(goldenArr.begin(), goldenArr.end());
+
+        bb_sort_dict_deferred::sort(arr);
+
+        test_arrays<T>(arr, goldenArr);
+    }
+}
+
+template <typename T>
+void test_parallel_distinct_count(){
+
+    std::cout << "test_parallel_distinct_count " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(37);
+    std::uniform_int_distribution<int> dist(-3000, 3000);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 200000; ++i) {
+        arr.emplace_back((T) dist(g) * 1000);
+    }
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    bb_sort::partitioned_count_map<T> counts(4);
+    counts.count(arr, 4);
+
+    long int total = 0;
+
+    for (const auto & partition : counts.Partitions) {
+
+        for (const auto & item : partition) {
+
+            total += item.second;
+            boost::ut::expect(counts.getPartition(item.first) == &partition - counts.Partitions.data());
+        }
+    }
+
+    boost::ut::expect(counts.size() == std::set<T>(arr.begin(), arr.end()).size());
+    boost::ut::expect(total == arr.size());
+
+    std::vector<T> multiThread(arr);
+    bb_sort::sortParallel(multiThread, 4);
+
+    test_arrays<T>(multiThread, goldenArr);
+
+    const int topN = 1000;
+
+    std::vector<T> top(arr);
+    const auto topSorted = bb_sort_top_n_lazy::getTopSortedLazyParallel(top, topN, 4);
+
+    test_arrays<T>(topSorted, std::vector<T>(goldenArr.begin(), goldenArr.begin() + topN));
+}
+
+template <typename T>
+void test_counted_bucket(){
+
+    std::cout << "test_counted_bucket " << typeid(T).name() << std::endl;
+
+    minmax::counted_bucket<T> first;
+
+    //counts start with the first item.
+    first.push(3, 2);
+
+    boost::ut::expect(first.Counts.length == 1 && first.getCount(0) == 2);
+
+    minmax::counted_bucket<T> bucket;
+
+    bucket.push(5, 1);
+    bucket.push(2, 1);
+    bucket.push(9, 1);
+
+    //unique items only, counts are not filled.
+    boost::ut::expect(bucket.Counts.length == 0);
+    boost::ut::expect(bucket.getCount(1) == 1);
+
+    bucket.push(7, 4);
+    bucket.push(1, 1);
+
+    boost::ut::expect(bucket.Counts.length == bucket.size());
+    boost::ut::expect(bucket.getCount(0) == 1 && bucket.getCount(3) == 4 && bucket.getCount(4) == 1);
+
+    boost::ut::expect(bucket.findMin() == 1);
+    boost::ut::expect(bucket.findMax() == 9);
+    boost::ut::expect(bucket.size() == 5);
+    boost::ut::expect(bucket.getTotal() == 8);
+}
+
+template <typename T>
+void test_dict_repeats(){
+
+    std::cout << "test_dict_repeats " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(41);
+    std::uniform_int_distribution<int> dist(-1000000000, 1000000000);
+    std::uniform_int_distribution<int> repeat(1, 20);
+
+    std::vector<T> arr;
+
+    //mostly unique items, every 100th one repeats.
+    for (int i = 0; i < 100000; ++i) {
+
+        const T item = (T) dist(g);
+        const int count = i % 100 == 0 ? repeat(g) : 1;
+
+        for (int j = 0; j < count; ++j) {
+            arr.emplace_back(item);
+        }
+    }
+
+    std::shuffle(arr.begin(), arr.end(), g);
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    std::vector<T> singleThread(arr);
+    bb_sort::sort(singleThread);
+    test_arrays<T>(singleThread, goldenArr);
+
+    std::vector<T> multiThread(arr);
+    bb_sort::sortParallel(multiThread, 4);
+    test_arrays<T>(multiThread, goldenArr);
+
+    const int topN = 5000;
+
+    std::vector<T> top(arr);
+    test_arrays<T>(bb_sort::getTopSorted(top, topN), std::vector<T>(goldenArr.begin(), goldenArr.begin() + topN));
+}
+
+void test_lazy_init_flags(){
+
+    std::cout << "test_lazy_init_flags" << std::endl;
+
+    pool::vector_lazy<pool::vector<int>> buckets(300);
+
+    buckets[3].push_back(1);
+    buckets[64].push_back(2);
+    buckets[200].push_back(3);
+
+    //initialized items are found across empty words, from the back.
+    boost::ut::expect(buckets.findPrevValue(buckets.size()) == 200);
+    boost::ut::expect(buckets.findPrevValue(200) == 64);
+    boost::ut::expect(buckets.findPrevValue(64) == 3);
+    boost::ut::expect(buckets.findPrevValue(3) == -1);
+
+    buckets.trimBack();
+    boost::ut::expect(buckets.size() == 201 && buckets.hasBack());
+
+    buckets.pop_back();
+    boost::ut::expect(!buckets.hasBack() && !buckets.hasValue(200));
+
+    buckets.trimBack();
+    boost::ut::expect(buckets.size() == 65 && buckets.back()[0] == 2);
+
+    buckets.emplace_back(pool::vector<int>{4});
+    boost::ut::expect(buckets.size() == 66 && buckets.hasBack() && buckets.findPrevValue(65) == 64);
+
+    pool::vector_lazy<pool::vector<int>> empty(100);
+    empty.trimBack();
+    boost::ut::expect(empty.empty());
+
+    //reset table keeps its array and has no initialized items.
+    buckets.reset(40);
+    boost::ut::expect(buckets.size() == 40 && buckets.findPrevValue(40) == -1);
 
-    test_arrays<T>(arrCopy, goldenArr);
-    test_arrays<T>(arrCopy2, goldenArr);
-    test_arrays<T>(arrCopy3, goldenArr);
+    buckets[10].push_back(5);
+    buckets.reset(300);
+    boost::ut::expect(buckets.size() == 300 && buckets.findPrevValue(300) == -1 && buckets[10].empty());
 }
 
-void test_bucket_worst_1() {
+template <typename T>
+void test_bucket_stack(){
 
-    std::cout << "test_bucket_worst_1" << std::endl;
+    std::cout << "test_bucket_stack " << typeid(T).name() << std::endl;
 
-    std::vector<float> arr = {0.0001, 0.0002, 0.0003, 1, 2, 3, 10, 20, 30, 100, 200, 300, 1000, 2000, 3000};
+    minmax::bucket_stack<T> st(3);
 
-    sort_and_test(arr);
+    st.push(0, T(5));
+    st.push(0, T(1));
+    st.push(0, T(3));
+    st.push(2, T(4));
+
+    //up to 3 items of a slot are held by min, mid and max, slot without items is just zero count.
+    boost::ut::expect(st.count(0) == 3 && st.count(1) == 0 && st.count(2) == 1);
+    boost::ut::expect(st.Mins.array[0] == T(1) && st.Mids.array[0] == T(3) && st.Maxs.array[0] == T(5));
+
+    st.push(0, T(2));
+
+    std::vector<T> items(st.Items.array[0], st.Items.array[0] + st.count(0));
+    std::sort(items.begin(), items.end());
+
+    test_arrays<T>(items, {T(1), T(2), T(3), T(5)});
+
+    //appending inline slot to spilled one and spilled one to inline one keeps all items.
+    minmax::bucket_stack<T> other(1);
+    other.push(0, T(7));
+    other.push(0, T(0));
+
+    st.append(0, other, 0);
+    boost::ut::expect(other.count(0) == 0 && st.count(0) == 6);
+
+    st.append(2, st, 0);
+
+    items.assign(st.Items.array[2], st.Items.array[2] + st.count(2));
+    std::sort(items.begin(), items.end());
+
+    boost::ut::expect(st.Mins.array[2] == T(0) && st.Maxs.array[2] == T(7));
+    test_arrays<T>(items, {T(0), T(1), T(2), T(3), T(4), T(5), T(7)});
+
+    //moved slot goes to the back of other stack, empty slots are trimmed.
+    st.moveSlot(2, other);
+    boost::ut::expect(other.size() == 2 && other.count(1) == 7 && st.count(2) == 0);
+
+    st.trimBack();
+    boost::ut::expect(st.empty());
 }
 
-void test_bucket_worst_2() {
+template <typename T>
+void test_pool_limits(){
 
-    std::cout << "test_bucket_worst_2" << std::endl;
+    std::cout << "test_pool_limits " << typeid(T).name() << std::endl;
 
-    std::vector<double> bucket_worse_arr;
-    std::vector<double> arrt = {0.000000000001, 0.000000000002, 0.000000000003};
-    double cluster = 10.0;
+    const std::size_t bytes = sizeof(T) * 64;
 
-    for (int i = 0; i < 15; ++i) {
+    pool::array_pool<T> arrays;
+    arrays.setLimits({2 * bytes, 3 * bytes});
 
-        for (auto const val : arrt) {
-            bucket_worse_arr.emplace_back(val * cluster);
-            cluster *= 10.0;
+    //third array of the same size is above the class limit, larger one is above the total limit, both are released right away.
+    arrays.warm(std::vector<std::size_t>{64, 64, 64, 1000});
+    boost::ut::expect(arrays.getIdleBytes() == 2 * bytes);
+
+    std::size_t size = 64;
+    T * rented = arrays.rentArray(size);
+    boost::ut::expect(size == 64 && arrays.getIdleBytes() == bytes);
+
+    arrays.returnArray(rented, size);
+    arrays.trim();
+    boost::ut::expect(arrays.getIdleBytes() == 0);
+
+    //shared pool keeps given arrays up to its limits and releases the rest.
+    pool::shared_array_pool<T> shared;
+    shared.setLimits({2 * bytes, 2 * bytes});
+
+    T * given[3];
+
+    for (auto & array : given) {
+        array = static_cast<T *>(pool::allocateArray(bytes));
+    }
+
+    shared.give(2, given, 3);
+    boost::ut::expect(shared.getIdleBytes() == 2 * bytes);
+
+    shared.trim({bytes, bytes});
+    boost::ut::expect(shared.getIdleBytes() == bytes);
+
+    shared.trim();
+    boost::ut::expect(shared.getIdleBytes() == 0);
+
+    //large arrays get their pages dropped before release, huge page ones are mapped aligned.
+    pool::array_pool<T> large;
+    large.warm(std::vector<std::size_t>{pool::adviseFrom / sizeof(T), pool::hugePageFrom});
+    boost::ut::expect(large.getIdleBytes() == sizeof(T) * pool::hugePageFrom + pool::adviseFrom);
+
+    std::size_t hugeSize = pool::hugePageFrom;
+    T * huge = large.rentArray(hugeSize);
+    boost::ut::expect((uintptr_t) huge % pool::hugePageSize == 0);
+
+    std::fill_n(huge, hugeSize, T(1));
+    large.returnArray(huge, hugeSize);
+
+    large.trim();
+    boost::ut::expect(large.getIdleBytes() == 0);
+}
+
+template <typename T>
+void test_concurrent_free_list(){
+
+    std::cout << "test_concurrent_free_list " << typeid(T).name() << std::endl;
+
+    const int threadCount = 4;
+    const int arrayCount = 1024;
+    const std::size_t bytes = sizeof(T) * 64;
+
+    pool::concurrent_object_pool<T> freeList;
+
+    std::vector<T *> arrays(threadCount * arrayCount);
+
+    for (auto & array : arrays) {
+        array = static_cast<T *>(pool::allocateArray(bytes));
+    }
+
+    //threads push own arrays in batches and pop concurrently, every array stays pooled exactly once.
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; ++t) {
+
+        threads.emplace_back([&, t] {
+
+            T * popped[4];
+
+            for (int i = 0; i < arrayCount; i += 8) {
+
+                freeList.push(arrays.data() + t * arrayCount + i, 8);
+
+                const int count = freeList.pop(popped, 4);
+                freeList.push(popped, count);
+            }
+        });
+    }
+
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    boost::ut::expect(freeList.size() == arrays.size());
+
+    std::set<T *> distinct;
+
+    while (T * array = freeList.pop()) {
+        distinct.insert(array);
+    }
+
+    boost::ut::expect(distinct.size() == arrays.size() && freeList.empty());
+
+    for (auto array : arrays) {
+        pool::freeArray(array, bytes);
+    }
+
+    //thread caches of the same shared pool exchange arrays concurrently and give all of them back when destroyed.
+    pool::shared_array_pool<T> shared;
+
+    threads.clear();
+
+    for (int t = 0; t < threadCount; ++t) {
+
+        threads.emplace_back([&] {
+
+            pool::array_pool<T> cache(&shared);
+
+            std::vector<T *> held;
+
+            for (int i = 0; i < 5000; ++i) {
+
+                std::size_t size = 64;
+                held.push_back(cache.rentArray(size));
+
+                if (held.size() == 100 || i == 4999) {
+
+                    for (auto array : held) {
+                        cache.returnArray(array, size);
+                    }
+
+                    held.clear();
+                }
+            }
+        });
+    }
+
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    const std::size_t idleBytes = shared.getIdleBytes();
+
+    T * taken[pool::shared_array_pool<T>::batchSize];
+
+    distinct.clear();
+
+    while (const int count = shared.take(2, taken, pool::shared_array_pool<T>::batchSize)) {
+        distinct.insert(taken, taken + count);
+        for (int i = 0; i < count; ++i) {
+            pool::freeArray(taken[i], bytes);
         }
     }
-    sort_and_test(bucket_worse_arr);
+
+    boost::ut::expect(idleBytes >= 100 * bytes && distinct.size() * bytes == idleBytes && shared.getIdleBytes() == 0);
 }
 
+template <typename T>
+void test_global_warm(){
 
-void  test_negative_ints() {
+    std::cout << "test_global_warm " << typeid(T).name() << std::endl;
 
-    std::cout << "test_negative_ints" << std::endl;
+    using global = pool::global_array_pool<T>;
 
-    std::vector<int> arr = {-5, -10, 0, -3, 8, 5, -1, 10};
-    sort_and_test(arr);
+    global::trim();
+
+    const std::size_t idle = global::SHARED_POOL.getIdleBytes();
+    const std::size_t bytes = pool::shared_array_pool<T>::getArrayBytes(pool::array_pool<T>::selectBucketIndex(3000));
+
+    //warmed arrays go to shared pool, so a thread other than the warming one rents them.
+    global::warm(std::vector<std::size_t>{3000});
+    boost::ut::expect(global::SHARED_POOL.getIdleBytes() == idle + bytes);
+
+    std::thread renter([&] {
+
+        std::size_t size = 3000;
+
+        T * array = global::GLOBAL_POOL.rentArray(size);
+
+        boost::ut::expect(global::SHARED_POOL.getIdleBytes() == idle);
+
+        global::GLOBAL_POOL.returnArray(array, size);
+    });
+
+    renter.join();
+
+    //cache of finished thread gives the array back to shared pool.
+    boost::ut::expect(global::SHARED_POOL.getIdleBytes() == idle + bytes);
+
+    global::trim();
 }
 
-void test_huge_gap(){
+template <typename T>
+void test_pool_stats(){
 
-    std::cout << "test_huge_gap" << std::endl;
+    std::cout << "test_pool_stats " << typeid(T).name() << std::endl;
 
-    std::vector<long> arr = {9, 8, 7, 1, 1000000000};
-    sort_and_test(arr);
+    pool::array_pool<T> arrays;
+
+    std::size_t size = 100;
+
+    T * first = arrays.rentArray(size);
+    T * second = arrays.rentArray(size);
+
+    arrays.returnArray(first, size);
+
+    T * third = arrays.rentArray(size);
+
+    arrays.returnArray(second, size);
+    arrays.returnArray(third, size);
+
+    const std::size_t bytes = sizeof(T) * size;
+
+    auto stats = arrays.getStats().snapshot();
+    auto & sizeClass = stats.Classes[3];
+
+    if constexpr (pool::poolStatsEnabled) {
+
+        boost::ut::expect(sizeClass.Rents == 3 && sizeClass.Hits == 1 && sizeClass.Misses == 2 && sizeClass.Returns == 3);
+        boost::ut::expect(sizeClass.BytesOutstanding == 0 && sizeClass.PeakBytes == 2 * bytes);
+        boost::ut::expect(stats.Total.Rents == 3 && stats.getHitRate() == 1.0 / 3);
+    }
+    else {
+
+        boost::ut::expect(stats.Total.Rents == 0 && stats.Total.PeakBytes == 0);
+    }
+
+    arrays.getStats().reset();
+
+    stats = arrays.getStats().snapshot();
+    boost::ut::expect(stats.Total.Rents == 0 && stats.Total.PeakBytes == 0);
+
+    //caches of a shared pool record to own counters, shared pool sums them, also of caches already destroyed.
+    pool::shared_array_pool<T> shared;
+    pool::array_pool<T> cache(&shared);
+
+    std::thread other([&] {
+
+        pool::array_pool<T> otherCache(&shared);
+
+        std::size_t otherSize = 100;
+
+        T * array = otherCache.rentArray(otherSize);
+        otherCache.returnArray(array, otherSize);
+    });
+
+    other.join();
+
+    T * array = cache.rentArray(size);
+    cache.returnArray(array, size);
+
+    const auto summed = shared.Stats.snapshot();
+
+    if constexpr (pool::poolStatsEnabled) {
+
+        boost::ut::expect(summed.Total.Rents == 2 && summed.Total.Returns == 2 && summed.Total.BytesOutstanding == 0);
+        boost::ut::expect(cache.getStats().snapshot().Total.Rents == 1);
+    }
+    else {
+
+        boost::ut::expect(summed.Total.Rents == 0);
+    }
+
+    shared.Stats.reset();
+    boost::ut::expect(shared.Stats.snapshot().Total.Rents == 0);
 }
 
-void test_float_huge_gap(){
+///Counts bytes allocated through it from sort arena.
+class counting_resource : public std::pmr::memory_resource {
 
-    std::cout << "test_float_huge_gap" << std::endl;
+    std::pmr::memory_resource * upstream;
 
-    std::vector<float> arr = {0.9, 0.8, 0.7, 0.1, 1000000000};
-    sort_and_test(arr);
+public:
+
+    long int Bytes = 0;
+
+    explicit counting_resource(std::pmr::memory_resource * upstream) : upstream(upstream) {}
+
+private:
+
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override {
+
+        Bytes += bytes;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override {
+
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override { return this == &other; }
+};
+
+template <typename T>
+void test_sort_arena(){
+
+    std::cout << "test_sort_arena " << typeid(T).name() << std::endl;
+
+    std::mt19937 g(47);
+    std::uniform_int_distribution<int> dist(-1000000, 1000000);
+
+    std::vector<T> arr;
+
+    for (int i = 0; i < 100000; ++i) {
+        arr.emplace_back((T) dist(g));
+    }
+
+    std::vector<T> goldenArr(arr);
+    sort(goldenArr.begin(), goldenArr.end());
+
+    auto testSort = [&](auto sortFunc) {
+
+        pool::sort_arena arena;
+        counting_resource counting(&arena);
+
+        std::vector<T> sorted(arr);
+        sortFunc(sorted, &counting);
+
+        test_arrays<T>(sorted, goldenArr);
+        boost::ut::expect(counting.Bytes > 0);
+    };
+
+    testSort([](auto & array, auto resource) { bb_sort::sort(array, resource); });
+    testSort([](auto & array, auto resource) { bb_sort_dictless::sort(array, resource); });
+    testSort([](auto & array, auto resource) { bb_sort_dictless_min_max_vect::sort(array, resource); });
+    testSort([](auto & array, auto resource) { bb_sort_dictless_min_max_vect::sort(array, resource, bb_sort::top_mapping::Cdf); });
+    testSort([](auto & array, auto resource) { bb_sort_dict_deferred::sort(array, resource); });
+    testSort([](auto & array, auto resource) { bb_sort_dictless_prefix_sum::sort(array, resource); });
+
+    const long int topN = 1000;
+
+    pool::sort_arena arena;
+
+    test_arrays<T>(bb_sort::getTopSorted(arr, topN, &arena), std::vector<T>(goldenArr.begin(), goldenArr.begin() + topN));
+    test_arrays<T>(bb_sort_top_n_lazy::getTopSortedLazy(arr, topN, &arena), std::vector<T>(goldenArr.begin(), goldenArr.begin() + topN));
+
+    //scope ends with the sort, later pool vectors rent from global pool again.
+    boost::ut::expect(pool::scopeResource == nullptr);
+
+    //dict bucket stack is a pmr container, it keeps resource of the scope it was made in.
+    counting_resource counting(&arena);
+
+    {
+        pool::memory_scope scope(&counting);
+
+        auto st = bb_sort::makeStack<T>();
+        st.emplace();
+
+        boost::ut::expect(counting.Bytes == sizeof(minmax::counted_bucket<T>));
+    }
 }
 
-void test_duplicates(){
+template <typename T>
+void test_sorter(){
 
-    std::cout << "test_duplicates" << std::endl;
+    std::cout << "test_sorter " << typeid(T).name() << std::endl;
 
-    std::vector<float> arr = {10, 20, 40, 50, 60, 69, 70, 70 , 70 , 70 , 70};
-    sort_and_test(arr);
+    std::mt19937 g(53);
+    std::uniform_int_distribution<int> dist(-1000000, 1000000);
+
+    //second batch has heavy hitters, so segment stacks are reused too.
+    std::vector<T> batches[2];
+
+    for (int i = 0; i < 50000; ++i) {
+        batches[0].emplace_back((T) dist(g));
+        batches[1].emplace_back((T) (i % 3 == 0 ? 7 : dist(g)));
+    }
+
+    bb_sort::sorter<T> sorter;
+
+    std::size_t idleBytes = 0;
+
+    for (int batch = 0; batch < 8; ++batch) {
+
+        std::vector<T> arr(batches[batch % 2]);
+
+        std::vector<T> goldenArr(arr);
+        sort(goldenArr.begin(), goldenArr.end());
+
+        const auto & top = sorter.getTopSorted(arr, 100);
+        test_arrays<T>(top, std::vector<T>(goldenArr.begin(), goldenArr.begin() + 100));
+
+        sorter.sort(arr);
+        test_arrays<T>(arr, goldenArr);
+
+        //scratch of every sort goes back to sorter resource, repeated batches rent it again after warm up.
+        if (batch >= 4) {
+            boost::ut::expect(sorter.getResource().getIdleBytes() == idleBytes);
+        }
+
+        idleBytes = sorter.getResource().getIdleBytes();
+    }
+
+    std::vector<T> single = {T(1)};
+    boost::ut::expect(sorter.getTopSorted(single, 10).size() == 1);
+
+    sorter.getResource().trim();
+    boost::ut::expect(sorter.getResource().getIdleBytes() == 0);
+}
+
+template <typename T>
+void test_concurrent_sorts(){
+
+    std::cout << "test_concurrent_sorts " << typeid(T).name() << std::endl;
+
+    const int threadCount = 4;
+
+    std::vector<std::vector<T>> arrays(threadCount);
+    std::vector<std::vector<T>> goldenArrays(threadCount);
+
+    for (int t = 0; t < threadCount; ++t) {
+
+        std::mt19937 g(43 + t);
+        std::uniform_int_distribution<int> dist(-1000000, 1000000);
+
+        for (int i = 0; i < 50000; ++i) {
+            arrays[t].emplace_back((T) dist(g));
+        }
+
+        goldenArrays[t] = arrays[t];
+        sort(goldenArrays[t].begin(), goldenArrays[t].end());
+    }
+
+    std::vector<std::vector<T>> sorted(threadCount);
+    std::vector<std::thread> threads;
+
+    //every thread sorts by own pool cache, finished threads give their arrays to shared pool.
+    for (int round = 0; round < 2; ++round) {
+
+        for (int t = 0; t < threadCount; ++t) {
+
+            threads.emplace_back([&, t] {
+
+                std::vector<T> dictless(arrays[t]);
+                bb_sort_dictless::sort(dictless);
+
+                sorted[t] = arrays[t];
+                bb_sort_dictless_min_max_vect::sort(sorted[t]);
+
+                if (dictless != sorted[t]) {
+                    sorted[t].clear();
+                }
+            });
+        }
+
+        for (auto & thread : threads) {
+            thread.join();
+        }
+
+        threads.clear();
+
+        for (int t = 0; t < threadCount; ++t) {
+            test_arrays<T>(sorted[t], goldenArrays[t]);
+        }
+    }
+
+    //buckets rented by one thread and released by another one go back through the shared pool.
+    pool::vector<T> rented;
+    rented.reserve(1000);
+
+    std::thread release([&] { pool::vector<T> released(std::move(rented)); });
+    release.join();
+
+    T * array[1];
+    boost::ut::expect(pool::global_array_pool<T>::SHARED_POOL.take(6, array, 1) == 1);
+    pool::global_array_pool<T>::SHARED_POOL.give(6, array, 1);
 }
 
 template <typename T>
@@ -499,6 +1685,86 @@ int main() {
 
         test_duplicates();
 
+        test_parallel_top_buckets<int>();
+
+        test_parallel_top_buckets<double>();
+
+        test_parallel_bucket_tasks<long>();
+
+        test_parallel_bucket_tasks<int>();
+
+        test_prefix_sum_scatter<long>();
+
+        test_bucket_map_kernel<int>();
+        test_bucket_map_kernel<float>();
+        test_bucket_map_kernel<double>();
+
+        test_integer_bucket_map<int>();
+        test_integer_bucket_map<long>();
+
+        test_ordered_bits_bucket_map<float>();
+        test_ordered_bits_bucket_map<double>();
+
+        test_bucket_map_keys<int>(1 << 29);
+        test_bucket_map_keys<unsigned>(1u << 30);
+        test_bucket_map_keys<long>(1700000000000000000l);
+        test_bucket_map_keys<unsigned long>(1ul << 62);
+        test_bucket_map_keys<float>(1000000.0f);
+        test_bucket_map_keys<double>(1000000.0);
+
+        test_adaptive_bucket_map<long>(1700000000000000000l);
+        test_adaptive_bucket_map<double>(1000000.0);
+
+        test_infinite_floats<float>();
+        test_infinite_floats<double>();
+
+        test_counting_sort<short>();
+        test_counting_sort<int>();
+
+        test_radix_sort<long>(-1000000000l, 7);
+        test_radix_sort<double>(1.0, std::numeric_limits<double>::epsilon());
+
+        test_cdf_bucket_map<long>();
+        test_cdf_bucket_map<double>();
+
+        test_heavy_hitters<int>();
+        test_heavy_hitters<double>();
+
+        test_dict_deferred<int>();
+        test_dict_deferred<double>();
+
+        test_parallel_distinct_count<int>();
+        test_parallel_distinct_count<double>();
+
+        test_counted_bucket<int>();
+        test_counted_bucket<double>();
+        test_dict_repeats<int>();
+        test_dict_repeats<float>();
+
+        test_concurrent_sorts<int>();
+        test_concurrent_sorts<double>();
+
+        test_lazy_init_flags();
+
+        test_bucket_stack<int>();
+        test_bucket_stack<double>();
+
+        test_pool_limits<int>();
+        test_pool_limits<double>();
+        test_concurrent_free_list<int>();
+        test_concurrent_free_list<double>();
+
+        test_global_warm<int>();
+        test_global_warm<double>();
+
+        test_pool_stats<int>();
+        test_pool_stats<double>();
+
+        test_sort_arena<int>();
+        test_sort_arena<double>();
+        test_sorter<int>();
+        test_sorter<double>();
+
         test_unique_reports<int>();
 
         test_duplicate_reports<int>();